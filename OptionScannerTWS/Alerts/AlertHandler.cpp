@@ -6,9 +6,13 @@ namespace Alerts {
 	// Alert Handler
 	//===================================================
 
-	AlertHandler::AlertHandler(std::shared_ptr<std::unordered_map<int, std::shared_ptr<ContractData>>> contractMap,
-		std::shared_ptr<OptionDB::DatabaseManager> dbm) :
-		contractMap_(contractMap), dbm_(dbm) {
+	AlertHandler::AlertHandler(const ContractRegistry& contracts, std::shared_ptr<OptionDB::DatabaseManager> dbm,
+		std::shared_ptr<const OutcomeGrid> grid) :
+		dbm_(dbm), grid_(std::move(grid)), pendingAlerts_(std::chrono::seconds(1), static_cast<size_t>(grid_->longestHorizon()) + 64),
+		contracts_(contracts) {
+
+		// Rejects a grid without its primary cell here rather than on the first alert
+		grid_->primaryCell();
 
 		// Start a thread to check the alerts
 		alertCheckThread_ = std::thread(&AlertHandler::checkAlertOutcomes, this);
@@ -20,108 +24,85 @@ namespace Alerts {
 	}
 
 	void AlertHandler::inputAlert(std::shared_ptr<CandleTags> candle) {
+		std::shared_ptr<PerformanceResults> alert = std::make_shared<PerformanceResults>(candle, grid_);
+		std::chrono::steady_clock::time_point deadline = alert->initTime + std::chrono::seconds(grid_->longestHorizon());
+
 		std::unique_lock<std::mutex> lock(alertMtx_);
-		std::shared_ptr<PerformanceResults> alert = std::make_shared<PerformanceResults>(candle);
-		alertUpdateQueue.push(alert);
+		bool sooner = deadline < pendingAlerts_.nextDeadline();
+		pendingAlerts_.schedule(alert, deadline);
 		lock.unlock();
-	}
-
-	void AlertHandler::checkAlertOutcomes() {
-		// Start time to reference and log win rate data every 30 minutes
-		std::chrono::steady_clock::time_point refTime = std::chrono::steady_clock::now();
-
-		while (!doneCheckingAlerts_) {
-			while (!alertUpdateQueue.empty()) {
-				// Check current time to see if 30 minutes have passed since the first alert was added to the queue
-				// When queue first starts, candles will get in deadlock with the database manager
-				std::unique_lock<std::mutex> lock(alertMtx_);
-				std::chrono::steady_clock::time_point prevAlertTIme = alertUpdateQueue.front()->initTime;
-				lock.unlock();
-				std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
-				std::chrono::minutes elsapsedTime = std::chrono::duration_cast<std::chrono::minutes>(currentTime - prevAlertTIme);
-
-				if (elsapsedTime >= std::chrono::minutes(30)) {
-					std::unique_lock<std::mutex> lock(alertMtx_);
 
-					std::shared_ptr<PerformanceResults> a = alertUpdateQueue.front();
-					// Access data from the contract map
-					std::vector<std::shared_ptr<Candle>> prevCandles = contractMap_->at(a->ct->candle.reqId())->candlesLast30Minutes();
+		// Alerts share one delay so this only fires for the first one after the wheel empties
+		if (sooner) alertCv_.notify_one();
 
-					// just use the lock to access the contract map
-					lock.unlock();
-
-					checkWinStats(prevCandles, a);
-
-					// Send to DB queue
-					dbm_->addToInsertionQueue(a);
-
-					alertUpdateQueue.pop();
-				}
-			}
-		}
+		ContractData* cd = contractOf(candle->candle);
+		if (cd) cd->trackOutcome(alert);
+		else OPTIONSCANNER_ERROR("No contract data found for alert on request {}", candle->candle.reqId());
 	}
 
-	void AlertHandler::doneCheckingAlerts() {
-		doneCheckingAlerts_ = true;
-		alertCheckThread_.join();
+	void AlertHandler::recordOutcome(std::shared_ptr<PerformanceResults> a) {
+		// Send to DB queue
+		dbm_->addToInsertionQueue(a);
 	}
 
-	//========================================================
-	// Helper Functions
-	//========================================================
+	void AlertHandler::recordOutcomeGrid(std::shared_ptr<PerformanceResults> a) {
+		dbm_->addOutcomesToInsertionQueue(a);
+	}
 
-	void checkWinStats(std::vector<std::shared_ptr<Candle>> prevCandles, std::shared_ptr<PerformanceResults> a) {
-		// Ensure we start at a vector candle that is after the alert time
-		// If we are close to the market close, it won't be a full 30 minutes
-		size_t i = 0;
+	void AlertHandler::checkAlertOutcomes() {
+		std::unique_lock<std::mutex> lock(alertMtx_);
 
-		while (a->ct->candle.time() > prevCandles[i]->time()) i++;
+		while (!doneCheckingAlerts_) {
+			std::chrono::steady_clock::time_point next = pendingAlerts_.nextDeadline();
+			if (next == std::chrono::steady_clock::time_point::max()) alertCv_.wait(lock);
+			else alertCv_.wait_until(lock, next);
+
+			if (doneCheckingAlerts_) break;
+
+			maturedAlerts_.clear();
+			pendingAlerts_.expire(std::chrono::steady_clock::now(), [this](std::shared_ptr<PerformanceResults>&& a) {
+				maturedAlerts_.push_back(std::move(a));
+			});
+			if (maturedAlerts_.empty()) continue;
+
+			// New alerts can keep coming in while the matured ones are measured
+			lock.unlock();
+			for (std::shared_ptr<PerformanceResults>& a : maturedAlerts_) closeOutcome(a);
+			lock.lock();
+		}
+	}
 
-		double startPrice = a->ct->candle.close();
-		double maxPrice = startPrice;
-		double minPrice = startPrice;
-		double percentChangeHigh = 0;
-		double percentChangeLow = 0;
-		long startTime = a->ct->candle.time();
-		long timeElapsed = 0;
+	void AlertHandler::closeOutcome(std::shared_ptr<PerformanceResults> a) {
+		// The contract reports whatever the alert hadn't yet, those that settled on their highest target
+		// or lowest stop were reported in full already
+		ContractData* cd = contractOf(a->ct->candle);
+		if (cd) {
+			cd->closeOutcome(a);
+			return;
+		}
 
-		for (i; i < prevCandles.size(); i++) {
+		// Without a contract nothing was tracked and the alert keeps its default result
+		recordOutcome(a);
+	}
 
-			// If percentChangeLow gets to -30% break and compare to percentChangeHigh
-			if (percentChangeLow <= -30.0) {
-				break;
-			}
+	ContractData* AlertHandler::contractOf(const Candle& candle) const {
+		// Access data from the contract registry
+		ContractData* cd = contracts_.at(candle.slot());
+		if (!cd) cd = contracts_.at(contracts_.slotOf(candle.reqId()));
+		return cd;
+	}
 
-			minPrice = min(minPrice, prevCandles[i]->low());
-			if (maxPrice < prevCandles[i]->high()) {
-				maxPrice = max(maxPrice, prevCandles[i]->high());
-				timeElapsed = prevCandles[i]->time();
-			}
+	void AlertHandler::doneCheckingAlerts() {
+		std::unique_lock<std::mutex> lock(alertMtx_);
+		doneCheckingAlerts_ = true;
+		lock.unlock();
+		alertCv_.notify_one();
 
-			percentChangeLow = ((minPrice - startPrice) / startPrice) * 100;
-			percentChangeHigh = ((maxPrice - startPrice) / startPrice) * 100;
-		}
+		if (alertCheckThread_.joinable()) alertCheckThread_.join();
+	}
 
-		if (percentChangeHigh <= 0) {
-			a->winLoss = 0;
-			a->winLossPct = percentChangeLow;
-		}
-		else  if (percentChangeHigh > 0 && percentChangeHigh < 60.0) {
-			// If percent gain is over 0, but win is negligible, like 0.05-0.10 this needs to be accounted for
-			if ((maxPrice - startPrice) > 0.10) {
-				a->winLoss = 0.5;
-			}
-			else {
-				a->winLoss = 0;
-			}
-
-			a->winLossPct = percentChangeHigh;
-			a->timeToWin = timeElapsed - startTime;
-		}
-		else {
-			a->winLoss = 1;
-			a->winLossPct = percentChangeHigh;
-			a->timeToWin = timeElapsed - startTime;
-		}
+	size_t AlertHandler::pendingAlerts() {
+		std::lock_guard<std::mutex> lock(alertMtx_);
+		return pendingAlerts_.size();
 	}
 }
\ No newline at end of file
@@ -17,7 +17,7 @@
 #pragma once
 
 #include <unordered_map>
-#include <queue>
+#include <condition_variable>
 #include <sstream>
 #include <map>
 #include <memory>
@@ -25,7 +25,9 @@
 #include "PerformanceResults.h"
 #include "Enums.h"
 #include "ContractData.h"
+#include "ContractRegistry.h"
 #include "Logger.h"
+#include "TimerWheel.h"
 
 using std::cout;
 using std::endl;
@@ -37,33 +39,46 @@ namespace Alerts {
 	class AlertHandler {
 	public:
 
-		AlertHandler(std::shared_ptr<std::unordered_map<int, std::shared_ptr<ContractData>>> contractMap,
-			std::shared_ptr<OptionDB::DatabaseManager> dbm);
+		// Each alert is followed over every horizon, target and stop of the grid
+		AlertHandler(const ContractRegistry& contracts, std::shared_ptr<OptionDB::DatabaseManager> dbm,
+			std::shared_ptr<const OutcomeGrid> grid = OutcomeGrid::standard());
 		~AlertHandler();
 
+		// Schedules the alert and registers it with its contract, which follows it bar by bar
 		void inputAlert(std::shared_ptr<CandleTags> candle);
 
+		// An alert's primary result goes to the db as soon as its contract has it final
+		void recordOutcome(std::shared_ptr<PerformanceResults> a);
+		// The whole grid follows once every cell is final, at the latest when the longest horizon ends
+		void recordOutcomeGrid(std::shared_ptr<PerformanceResults> a);
+
 		// **** Be sure to take into account alerts right before close
+		// Sleeps until the next alert matures, inputAlert wakes it early if a new one is due sooner
 		void checkAlertOutcomes();
-		void doneCheckingAlerts();
+		void doneCheckingAlerts(); // Call on market close
 
-		bool doneCheckingAlerts_{ false }; // Change to true on market close
+		size_t pendingAlerts();
 		//void outputAlert();
 
 	private:
+		void closeOutcome(std::shared_ptr<PerformanceResults> a);
+		ContractData* contractOf(const Candle& candle) const;
+
 		std::mutex alertMtx_;
+		std::condition_variable alertCv_;
 		std::thread alertCheckThread_;
+		bool doneCheckingAlerts_{ false };
 
 		std::shared_ptr<OptionDB::DatabaseManager> dbm_;
 
 		// std::unordered_map<int, AlertNode> alertStorage;
-		std::queue<std::shared_ptr<PerformanceResults>> alertUpdateQueue;
+		// Alerts waiting out the grid's longest horizon, one second ticks with a turn a little longer than that
+		std::shared_ptr<const OutcomeGrid> grid_;
+		TimerWheel<std::shared_ptr<PerformanceResults>> pendingAlerts_;
+		std::vector<std::shared_ptr<PerformanceResults>> maturedAlerts_;
 
-		// Points to the map being updated by the Option Scanner
-		std::shared_ptr<std::unordered_map<int, std::shared_ptr<ContractData>>> contractMap_;
+		// Contracts being updated by the Option Scanner, looked up by the slot on each alert candle
+		const ContractRegistry& contracts_;
 	};
 
-	// Measure the win rate and the percent win of each alert
-	void checkWinStats(std::vector<std::shared_ptr<Candle>> prevCandles, std::shared_ptr<PerformanceResults> a);
-
 }
\ No newline at end of file
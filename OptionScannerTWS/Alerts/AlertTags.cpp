@@ -9,6 +9,37 @@ namespace Alerts {
 		underlyingPriceDelta(underlyingPriceDelta), optionPriceDelta(optionPriceDelta), underlyingDailyHL(underlyingDailyHL),
 		underlyingLocalHL(underlyingLocalHL), optionDailyHL(optionDailyHL), optionLocalHL(optionLocalHL) {}
 
+	AlertTags::AlertTags(TagWord word) :
+		optType(word.get<OptionType>(TagCategory::OptionType)),
+		timeFrame(word.get<TimeFrame>(TagCategory::TimeFrame)),
+		rtm(word.get<RelativeToMoney>(TagCategory::RelativeToMoney)),
+		timeOfDay(word.get<TimeOfDay>(TagCategory::TimeOfDay)),
+		volStDev(word.get<VolumeStDev>(TagCategory::VolumeStDev)),
+		volThreshold(word.get<VolumeThreshold>(TagCategory::VolumeThreshold)),
+		underlyingPriceDelta(word.get<PriceDelta>(TagCategory::UnderlyingPriceDelta)),
+		optionPriceDelta(word.get<PriceDelta>(TagCategory::OptionPriceDelta)),
+		underlyingDailyHL(word.get<DailyHighsAndLows>(TagCategory::UnderlyingDailyHighsAndLows)),
+		underlyingLocalHL(word.get<LocalHighsAndLows>(TagCategory::UnderlyingLocalHighsAndLows)),
+		optionDailyHL(word.get<DailyHighsAndLows>(TagCategory::OptionDailyHighsAndLows)),
+		optionLocalHL(word.get<LocalHighsAndLows>(TagCategory::OptionLocalHighsAndLows)) {}
+
+	TagWord AlertTags::word() const {
+		TagWord w;
+		w.set(TagCategory::OptionType, optType)
+			.set(TagCategory::TimeFrame, timeFrame)
+			.set(TagCategory::RelativeToMoney, rtm)
+			.set(TagCategory::TimeOfDay, timeOfDay)
+			.set(TagCategory::VolumeStDev, volStDev)
+			.set(TagCategory::VolumeThreshold, volThreshold)
+			.set(TagCategory::UnderlyingPriceDelta, underlyingPriceDelta)
+			.set(TagCategory::OptionPriceDelta, optionPriceDelta)
+			.set(TagCategory::UnderlyingDailyHighsAndLows, underlyingDailyHL)
+			.set(TagCategory::UnderlyingLocalHighsAndLows, underlyingLocalHL)
+			.set(TagCategory::OptionDailyHighsAndLows, optionDailyHL)
+			.set(TagCategory::OptionLocalHighsAndLows, optionLocalHL);
+		return w;
+	}
+
 	//==================================
 	// Alert Stats
 	//==================================
@@ -41,54 +72,45 @@ namespace Alerts {
 	// Alert Tag Stats
 	//==================================================
 
-	void AlertTagStats::updateStats(AlertTags tags, double win, double pctWon) {
+	void AlertTagStats::updateStats(AlertTags tags, double win, double pctWon) { updateStats(tags.word(), win, pctWon); }
 
-		if (alertSpecificStats_.find(tags) != alertSpecificStats_.end()) {
-			alertSpecificStats_[tags].updateAlertStats(win, pctWon);
-		}
-		else {
-			AlertStats ast;
-			ast.updateAlertStats(win, pctWon);
-			alertSpecificStats_.insert({ tags, ast });
+	void AlertTagStats::updateStats(TagWord tags, double win, double pctWon) {
+
+		// Inserts a zeroed entry the first time a combination is seen
+		alertSpecificStats_[tags].updateAlertStats(win, pctWon);
+
+		for (size_t i = 0; i < kNumTagCategories; i++) {
+			tagStats_[tags.dbId(static_cast<TagCategory>(i)) - 1].updateAlertStats(win, pctWon);
 		}
-			 
-		updateStatsMap(optionTypeStats_, tags.optType, win, pctWon);
-		updateStatsMap(timeFrameStats_, tags.timeFrame, win, pctWon);
-		updateStatsMap(relativeToMoneyStats_, tags.rtm, win, pctWon);
-		updateStatsMap(timeOfDayStats_, tags.timeOfDay, win, pctWon);
-		updateStatsMap(volStDevStats_, tags.volStDev, win, pctWon);
-		updateStatsMap(volThresholdStats_, tags.volThreshold, win, pctWon);
-		updateStatsMap(underlyingPriceDeltaStats_, tags.underlyingPriceDelta, win, pctWon);
-		updateStatsMap(optionPriceDeltaStats_, tags.optionPriceDelta, win, pctWon);
-		updateStatsMap(uDailyHLStats_, tags.underlyingDailyHL, win, pctWon);
-		updateStatsMap(uLocalHLStats_, tags.underlyingLocalHL, win, pctWon);
-		updateStatsMap(oDailyHLStats_, tags.optionDailyHL, win, pctWon);
-		updateStatsMap(oLocalHLStats_, tags.optionLocalHL, win, pctWon);
 	}
 
-	AlertStats AlertTagStats::alertSpecificStats(AlertTags tags) {
-		if (alertSpecificStats_.find(tags) == alertSpecificStats_.end()) {
-			// If no data, insert a class with 0 values
-			AlertStats ast;
-			alertSpecificStats_.insert({ tags, ast });
-		}
+	AlertStats AlertTagStats::alertSpecificStats(AlertTags tags) const {
+		// If no data, return a class with 0 values
+		const AlertStats* stats = alertSpecificStats_.find(tags.word());
+		return stats ? *stats : AlertStats();
+	}
 
-		return alertSpecificStats_.at(tags);
+	size_t AlertTagStats::combinationsSeen() const { return alertSpecificStats_.size(); }
+
+	AlertStats AlertTagStats::tagStats(TagCategory category, int value) const {
+		size_t i = TagFields::index(category);
+		if (value < 0 || value >= kTagValues[i]) return AlertStats();
+		return tagStats_[TagFields::dbBase(i) - 1 + value];
 	}
 
 	// Alert type accessors
-	AlertStats AlertTagStats::optionTypeStats(OptionType key) { return checkStatsMap(key, optionTypeStats_); }
-	AlertStats AlertTagStats::timeFrameStats(TimeFrame key) { return checkStatsMap(key, timeFrameStats_); }
-	AlertStats AlertTagStats::relativeToMoneyStats(RelativeToMoney key) { return checkStatsMap(key, relativeToMoneyStats_); }
-	AlertStats AlertTagStats::timeOfDayStats(TimeOfDay key) { return checkStatsMap(key, timeOfDayStats_); }
-	AlertStats AlertTagStats::volStDevStats(VolumeStDev key) { return checkStatsMap(key, volStDevStats_); }
-	AlertStats AlertTagStats::volThresholdStats(VolumeThreshold key) { return checkStatsMap(key, volThresholdStats_); }
-	AlertStats AlertTagStats::underlyingDeltaStats(PriceDelta key) { return checkStatsMap(key, underlyingPriceDeltaStats_); }
-	AlertStats AlertTagStats::optionDeltaStats(PriceDelta key) { return checkStatsMap(key, optionPriceDeltaStats_); }
-	AlertStats AlertTagStats::underlyingDailyHLStats(DailyHighsAndLows key) { return checkStatsMap(key, uDailyHLStats_); }
-	AlertStats AlertTagStats::underlyingLocalHLStats(LocalHighsAndLows key) { return checkStatsMap(key, uLocalHLStats_); }
-	AlertStats AlertTagStats::optionDailyHLStats(DailyHighsAndLows key) { return checkStatsMap(key, oDailyHLStats_); }
-	AlertStats AlertTagStats::optionLocalHLStats(LocalHighsAndLows key) { return checkStatsMap(key, oLocalHLStats_); }
+	AlertStats AlertTagStats::optionTypeStats(OptionType key) { return tagStats(TagCategory::OptionType, static_cast<int>(key)); }
+	AlertStats AlertTagStats::timeFrameStats(TimeFrame key) { return tagStats(TagCategory::TimeFrame, static_cast<int>(key)); }
+	AlertStats AlertTagStats::relativeToMoneyStats(RelativeToMoney key) { return tagStats(TagCategory::RelativeToMoney, static_cast<int>(key)); }
+	AlertStats AlertTagStats::timeOfDayStats(TimeOfDay key) { return tagStats(TagCategory::TimeOfDay, static_cast<int>(key)); }
+	AlertStats AlertTagStats::volStDevStats(VolumeStDev key) { return tagStats(TagCategory::VolumeStDev, static_cast<int>(key)); }
+	AlertStats AlertTagStats::volThresholdStats(VolumeThreshold key) { return tagStats(TagCategory::VolumeThreshold, static_cast<int>(key)); }
+	AlertStats AlertTagStats::underlyingDeltaStats(PriceDelta key) { return tagStats(TagCategory::UnderlyingPriceDelta, static_cast<int>(key)); }
+	AlertStats AlertTagStats::optionDeltaStats(PriceDelta key) { return tagStats(TagCategory::OptionPriceDelta, static_cast<int>(key)); }
+	AlertStats AlertTagStats::underlyingDailyHLStats(DailyHighsAndLows key) { return tagStats(TagCategory::UnderlyingDailyHighsAndLows, static_cast<int>(key)); }
+	AlertStats AlertTagStats::underlyingLocalHLStats(LocalHighsAndLows key) { return tagStats(TagCategory::UnderlyingLocalHighsAndLows, static_cast<int>(key)); }
+	AlertStats AlertTagStats::optionDailyHLStats(DailyHighsAndLows key) { return tagStats(TagCategory::OptionDailyHighsAndLows, static_cast<int>(key)); }
+	AlertStats AlertTagStats::optionLocalHLStats(LocalHighsAndLows key) { return tagStats(TagCategory::OptionLocalHighsAndLows, static_cast<int>(key)); }
 
 	void AlertTagStats::logAllTagStats() {
 #ifndef TEST_CONFIG
@@ -158,65 +180,7 @@ namespace Alerts {
 #endif // !TEST_CONFIG
 	}
 
-	template<typename T>
-	AlertStats AlertTagStats::checkStatsMap(T key, std::unordered_map<T, AlertStats>& statsMap) {
-		if (statsMap.find(key) == statsMap.end()) {
-			AlertStats ast;
-			statsMap.insert({ key, ast });
-		}
-
-		return statsMap.at(key);
-	}
-
-	template<typename T>
-	void updateStatsMap(std::unordered_map<T, AlertStats>& statsMap, T key, double win, double pctWon) {
-		if (statsMap.find(key) != statsMap.end()) {
-			statsMap[key].updateAlertStats(win, pctWon);
-		}
-		else {
-			AlertStats ast;
-			ast.updateAlertStats(win, pctWon);
-			statsMap.insert({ key, ast });
-		}
-	}
-
-	bool operator<(const AlertTags& left, const AlertTags& right) {
-		if (left.optType < right.optType) return true;
-		if (right.optType < left.optType) return false;
-
-		if (left.timeFrame < right.timeFrame) return true;
-		if (right.timeFrame < left.timeFrame) return false;
-
-		if (left.rtm < right.rtm) return true;
-		if (right.rtm < left.rtm) return false;
-
-		if (left.timeOfDay < right.timeOfDay) return true;
-		if (right.timeOfDay < left.timeOfDay) return false;
-
-		if (left.volStDev < right.volStDev) return true;
-		if (right.volStDev < left.volStDev) return false;
-
-		if (left.volThreshold < right.volThreshold) return true;
-		if (right.volThreshold < left.volThreshold) return false;
+	std::size_t AlertTagHash::operator()(const AlertTags& tags) const { return std::hash<TagWord>()(tags.word()); }
 
-		if (left.underlyingPriceDelta < right.underlyingPriceDelta) return true;
-		if (right.underlyingPriceDelta < left.underlyingPriceDelta) return false;
-
-		if (left.optionPriceDelta < right.optionPriceDelta) return true;
-		if (right.optionPriceDelta < left.optionPriceDelta) return false;
-
-		if (left.underlyingDailyHL < right.underlyingDailyHL) return true;
-		if (right.underlyingDailyHL < left.underlyingDailyHL) return false;
-
-		if (left.underlyingLocalHL < right.underlyingLocalHL) return true;
-		if (right.underlyingLocalHL < left.underlyingLocalHL) return false;
-
-		if (left.optionDailyHL < right.optionDailyHL) return true;
-		if (right.optionDailyHL < left.optionDailyHL) return false;
-
-		if (left.optionLocalHL < right.optionLocalHL) return true;
-		if (right.optionLocalHL < left.optionLocalHL) return false;
-
-		return false; // If all numbers are equal, return false
-	}
+	bool operator<(const AlertTags& left, const AlertTags& right) { return left.word() < right.word(); }
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include <map>
 
 #include "../Enums.h"
+#include "../TagWord.h"
+#include "../TagWordTable.h"
 
 #ifndef TEST_CONFIG
 #include "../Logger.h"
@@ -32,6 +34,10 @@ namespace Alerts {
 		AlertTags(OptionType optType, TimeFrame timeFrame, RelativeToMoney rtm, TimeOfDay timeOfDay, VolumeStDev volStDev,
 			VolumeThreshold volThreshold, PriceDelta underlyingPriceDelta, PriceDelta optionPriceDelta,
 			DailyHighsAndLows underlyingDailyHL, LocalHighsAndLows underlyingLocalHL, DailyHighsAndLows optionDailyHL, LocalHighsAndLows optionLocalHL);
+		explicit AlertTags(TagWord word);
+
+		// All twelve tags packed into one word, used for comparison, hashing and stats lookup
+		TagWord word() const;
 	};
 
 	class AlertStats {
@@ -62,12 +68,18 @@ namespace Alerts {
 		std::size_t operator()(const AlertTags& tags) const;
 	};
 
+	// One hash probe for the full combination and one array slot per tag to update an alert
 	class AlertTagStats {
 	public:
 
 		void updateStats(AlertTags tags, double win, double pctWon);
+		void updateStats(TagWord tags, double win, double pctWon);
+
+		AlertStats alertSpecificStats(AlertTags tags) const;
+		size_t combinationsSeen() const;
 
-		AlertStats alertSpecificStats(AlertTags tags);
+		// Stats of every alert holding one value of a tag, zeroed if there are none
+		AlertStats tagStats(TagCategory category, int value) const;
 		
 		// Alert type accessors
 		AlertStats optionTypeStats(OptionType key);
@@ -85,32 +97,14 @@ namespace Alerts {
 
 		void logAllTagStats();
 
-		// This helper template will simplify checking if a map has a value or not
-		template<typename T>
-		AlertStats checkStatsMap(T key, std::unordered_map<T, AlertStats>& statsMap);
-
 	private:
 
-		// Contains data for all specific alert combinations
-		std::map<AlertTags, AlertStats> alertSpecificStats_;
-
-		// Individual tag stats
-		std::unordered_map<OptionType, AlertStats> optionTypeStats_;
-		std::unordered_map<TimeFrame, AlertStats> timeFrameStats_;
-		std::unordered_map<RelativeToMoney, AlertStats> relativeToMoneyStats_;
-		std::unordered_map<TimeOfDay, AlertStats> timeOfDayStats_;
-		std::unordered_map<VolumeStDev, AlertStats> volStDevStats_;
-		std::unordered_map<VolumeThreshold, AlertStats> volThresholdStats_;
-		std::unordered_map<PriceDelta, AlertStats> underlyingPriceDeltaStats_;
-		std::unordered_map<PriceDelta, AlertStats> optionPriceDeltaStats_;
-		std::unordered_map<DailyHighsAndLows, AlertStats> uDailyHLStats_;
-		std::unordered_map<LocalHighsAndLows, AlertStats> uLocalHLStats_;
-		std::unordered_map<DailyHighsAndLows, AlertStats> oDailyHLStats_;
-		std::unordered_map<LocalHighsAndLows, AlertStats> oLocalHLStats_;
-	};
+		// Contains data for all specific alert combinations, keyed on the packed tags
+		TagWordTable<AlertStats> alertSpecificStats_;
 
-	template<typename T>
-	void updateStatsMap(std::unordered_map<T, AlertStats>& statsMap, T key, double win, double pctWon);
+		// Individual tag stats, one slot per tag value laid out like the AlertTags table ids
+		AlertStats tagStats_[TagFields::kNumDbIds];
+	};
 
 	// Comparison operator to hold alertTags in a map
 	bool operator<(const AlertTags& left, const AlertTags& right);
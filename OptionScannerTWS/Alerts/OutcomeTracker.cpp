@@ -0,0 +1,165 @@
+#include "OutcomeTracker.h"
+
+namespace Alerts {
+
+	//===================================================
+	// Grid and Matrix
+	//===================================================
+
+	size_t OutcomeGrid::cells() const { return horizons.size() * targets.size() * stops.size(); }
+
+	size_t OutcomeGrid::index(size_t horizon, size_t target, size_t stop) const {
+		return (horizon * targets.size() + target) * stops.size() + stop;
+	}
+
+	size_t OutcomeGrid::primaryCell() const {
+		for (size_t h = 0; h < horizons.size(); h++) {
+			for (size_t t = 0; t < targets.size(); t++) {
+				for (size_t s = 0; s < stops.size(); s++) {
+					if (horizons[h] == primaryHorizon && targets[t] == primaryTarget && stops[s] == primaryStop) return index(h, t, s);
+				}
+			}
+		}
+		throw std::invalid_argument("Primary outcome horizon, target and stop must all be on the outcome grid");
+	}
+
+	long OutcomeGrid::longestHorizon() const { return horizons.empty() ? 0 : horizons.back(); }
+
+	std::shared_ptr<const OutcomeGrid> OutcomeGrid::standard() {
+		static const std::shared_ptr<const OutcomeGrid> grid = std::make_shared<OutcomeGrid>();
+		return grid;
+	}
+
+	OutcomeMatrix::OutcomeMatrix(std::shared_ptr<const OutcomeGrid> grid) : grid_(std::move(grid)), cells_(grid_->cells()) {}
+
+	const OutcomeResult& OutcomeMatrix::at(size_t horizon, size_t target, size_t stop) const {
+		return cells_[grid_->index(horizon, target, stop)];
+	}
+
+	OutcomeResult& OutcomeMatrix::at(size_t horizon, size_t target, size_t stop) {
+		return cells_[grid_->index(horizon, target, stop)];
+	}
+
+	const OutcomeResult& OutcomeMatrix::primary() const { return cells_[grid_->primaryCell()]; }
+	const OutcomeGrid& OutcomeMatrix::grid() const { return *grid_; }
+	bool OutcomeMatrix::empty() const { return cells_.empty(); }
+
+	//===================================================
+	// Tracker
+	//===================================================
+
+	OutcomeTracker::OutcomeTracker(long startTime, double startPrice, std::shared_ptr<const OutcomeGrid> grid) :
+		grid_(std::move(grid)), startTime_(startTime), startPrice_(startPrice), lastTime_(startTime - 1),
+		maxPrice_(startPrice), minPrice_(startPrice),
+		horizonEnds_(grid_->horizons.size()), targetHits_(grid_->targets.size()), stopHits_(grid_->stops.size()) {
+
+		size_t cell = grid_->primaryCell();
+		primaryStop_ = cell % grid_->stops.size();
+		primaryTarget_ = (cell / grid_->stops.size()) % grid_->targets.size();
+		primaryHorizon_ = cell / (grid_->stops.size() * grid_->targets.size());
+	}
+
+	bool OutcomeTracker::update(long time, double high, double low) {
+		if (state_ != State::Open) return true;
+		if (time <= lastTime_) return false;
+
+		// Horizons that end before this bar
+		const std::vector<long>& horizons = grid_->horizons;
+		while (nextHorizon_ < horizons.size() && time - startTime_ >= horizons[nextHorizon_]) horizonEnds_[nextHorizon_++] = current();
+		if (nextHorizon_ == horizons.size()) {
+			state_ = State::Closed;
+			return true;
+		}
+
+		lastTime_ = time;
+		bars_++;
+
+		if (high > maxPrice_) {
+			maxPrice_ = high;
+			highTime_ = time;
+		}
+		if (low < minPrice_) minPrice_ = low;
+
+		// The bar that reaches a level still counts toward it, a bar reaching a target and a stop is a win
+		double percentChangeHigh = ((maxPrice_ - startPrice_) / startPrice_) * 100;
+		double percentChangeLow = ((minPrice_ - startPrice_) / startPrice_) * 100;
+
+		const std::vector<double>& targets = grid_->targets;
+		const std::vector<double>& stops = grid_->stops;
+		while (nextTarget_ < targets.size() && percentChangeHigh >= targets[nextTarget_]) targetHits_[nextTarget_++] = current();
+		while (nextStop_ < stops.size() && percentChangeLow <= stops[nextStop_]) stopHits_[nextStop_++] = current();
+
+		if (nextTarget_ == targets.size()) state_ = State::HitTarget;
+		else if (nextStop_ == stops.size()) state_ = State::StoppedOut;
+
+		return state_ != State::Open;
+	}
+
+	void OutcomeTracker::close() {
+		if (state_ == State::Open) state_ = State::Closed;
+	}
+
+	bool OutcomeTracker::done() const { return state_ != State::Open; }
+
+	bool OutcomeTracker::primaryDone() const {
+		return done() || primaryHorizon_ < nextHorizon_ || primaryTarget_ < nextTarget_ || primaryStop_ < nextStop_;
+	}
+
+	OutcomeTracker::State OutcomeTracker::state() const { return state_; }
+	size_t OutcomeTracker::bars() const { return bars_; }
+
+	OutcomeMatrix OutcomeTracker::results() const {
+		OutcomeMatrix matrix(grid_);
+		Snapshot now = current();
+
+		for (size_t h = 0; h < grid_->horizons.size(); h++) {
+			for (size_t t = 0; t < grid_->targets.size(); t++) {
+				for (size_t s = 0; s < grid_->stops.size(); s++) {
+					matrix.at(h, t, s) = resultOf(cellEnd(h, t, s, now), grid_->targets[t]);
+				}
+			}
+		}
+
+		return matrix;
+	}
+
+	OutcomeResult OutcomeTracker::result() const {
+		return resultOf(cellEnd(primaryHorizon_, primaryTarget_, primaryStop_, current()), grid_->targets[primaryTarget_]);
+	}
+
+	OutcomeTracker::Snapshot OutcomeTracker::current() const { return { bars_, maxPrice_, minPrice_, highTime_ }; }
+
+	const OutcomeTracker::Snapshot& OutcomeTracker::cellEnd(size_t horizon, size_t target, size_t stop, const Snapshot& now) const {
+		// Whichever of the cell's horizon, target and stop came first, levels not reached yet end with the bars so far
+		const Snapshot* end = &now;
+		if (horizon < nextHorizon_ && horizonEnds_[horizon].bars < end->bars) end = &horizonEnds_[horizon];
+		if (target < nextTarget_ && targetHits_[target].bars < end->bars) end = &targetHits_[target];
+		if (stop < nextStop_ && stopHits_[stop].bars < end->bars) end = &stopHits_[stop];
+		return *end;
+	}
+
+	OutcomeResult OutcomeTracker::resultOf(const Snapshot& s, double target) const {
+		OutcomeResult r;
+		double percentChangeLow = ((s.minPrice - startPrice_) / startPrice_) * 100;
+		double percentChangeHigh = ((s.maxPrice - startPrice_) / startPrice_) * 100;
+
+		if (percentChangeHigh <= 0) {
+			r.winLoss = 0;
+			r.winLossPct = percentChangeLow;
+		}
+		else if (percentChangeHigh < target) {
+			// If percent gain is over 0, but win is negligible, like 0.05-0.10 this needs to be accounted for
+			r.winLoss = (s.maxPrice - startPrice_) > 0.10 ? 0.5f : 0.0f;
+			r.winLossPct = percentChangeHigh;
+			r.timeToWin = static_cast<int>(s.highTime - startTime_);
+		}
+		else {
+			r.winLoss = 1;
+			r.winLossPct = percentChangeHigh;
+			r.timeToWin = static_cast<int>(s.highTime - startTime_);
+		}
+
+		return r;
+	}
+
+}
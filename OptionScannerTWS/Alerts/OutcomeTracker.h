@@ -0,0 +1,129 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Running outcome of a single alert. The contract feeds it every 5
+// second bar from the alert's own bar on, and one pass over those bars
+// fills a matrix of results for every horizon, target and stop of the
+// grid. Only the running high, low and time of the high are kept, along
+// with a snapshot of them each time a horizon ends or a target or stop
+// level is first reached. A cell's result is the snapshot of whichever
+// of its three came first. The tracker is final as soon as the highest
+// target or lowest stop is hit, otherwise once the longest horizon ends.
+// The primary cell is final as soon as any of its own three is reached
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace Alerts {
+
+	// Horizons in seconds and ascending, targets in percent gained and ascending,
+	// stops in percent lost (negative) and descending
+	struct OutcomeGrid {
+		std::vector<long> horizons{ 60, 300, 900, 1800, 3600 };
+		std::vector<double> targets{ 20, 40, 60, 100 };
+		std::vector<double> stops{ -10, -20, -30, -50 };
+
+		// The cell kept as the alert's own result and posted to the db
+		long primaryHorizon{ 1800 };
+		double primaryTarget{ 60 };
+		double primaryStop{ -30 };
+
+		size_t cells() const;
+		size_t index(size_t horizon, size_t target, size_t stop) const;
+		size_t primaryCell() const; // Throws std::invalid_argument if the primary values aren't on the grid
+		long longestHorizon() const;
+
+		// Shared default grid
+		static std::shared_ptr<const OutcomeGrid> standard();
+	};
+
+	struct OutcomeResult {
+		float winLoss{ -1 };
+		double winLossPct{ 0 };
+		int timeToWin{ 0 };
+	};
+
+	// Results of one alert by horizon, target and stop
+	class OutcomeMatrix {
+	public:
+		OutcomeMatrix() = default;
+		explicit OutcomeMatrix(std::shared_ptr<const OutcomeGrid> grid);
+
+		const OutcomeResult& at(size_t horizon, size_t target, size_t stop) const;
+		OutcomeResult& at(size_t horizon, size_t target, size_t stop);
+		const OutcomeResult& primary() const;
+
+		const OutcomeGrid& grid() const;
+		bool empty() const;
+
+	private:
+		std::shared_ptr<const OutcomeGrid> grid_;
+		std::vector<OutcomeResult> cells_;
+	};
+
+	class OutcomeTracker {
+	public:
+		enum class State { Open, StoppedOut, HitTarget, Closed };
+
+		// Throws std::invalid_argument if the grid's primary cell isn't on it
+		OutcomeTracker(long startTime, double startPrice, std::shared_ptr<const OutcomeGrid> grid = OutcomeGrid::standard());
+
+		// Folds in one 5 second bar, bars before the alert or already seen are skipped
+		// Returns true once every cell is final
+		bool update(long time, double high, double low);
+
+		// End of the longest horizon, final with whatever has been seen
+		void close();
+
+		bool done() const;
+		bool primaryDone() const; // The primary cell's horizon, target or stop has been reached
+		State state() const;
+		size_t bars() const;
+
+		// Cells not final yet use the bars seen so far
+		OutcomeMatrix results() const;
+		OutcomeResult result() const; // The grid's primary cell
+
+	private:
+		struct Snapshot {
+			size_t bars{ 0 };
+			double maxPrice{ 0 };
+			double minPrice{ 0 };
+			long highTime{ 0 };
+		};
+
+		Snapshot current() const;
+		OutcomeResult resultOf(const Snapshot& s, double target) const;
+		const Snapshot& cellEnd(size_t horizon, size_t target, size_t stop, const Snapshot& now) const;
+
+		std::shared_ptr<const OutcomeGrid> grid_;
+		size_t primaryHorizon_;
+		size_t primaryTarget_;
+		size_t primaryStop_;
+
+		long startTime_;
+		double startPrice_;
+		long lastTime_;
+
+		double maxPrice_;
+		double minPrice_;
+		long highTime_{ 0 }; // First bar to make the current high
+		size_t bars_{ 0 };
+
+		// Levels are reached in order, so each only needs the index of the next one
+		std::vector<Snapshot> horizonEnds_;
+		std::vector<Snapshot> targetHits_;
+		std::vector<Snapshot> stopHits_;
+		size_t nextHorizon_{ 0 };
+		size_t nextTarget_{ 0 };
+		size_t nextStop_{ 0 };
+
+		State state_{ State::Open };
+	};
+
+}
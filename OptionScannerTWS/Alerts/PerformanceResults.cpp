@@ -2,9 +2,23 @@
 
 namespace Alerts {
 
-	PerformanceResults::PerformanceResults(std::shared_ptr<CandleTags> candle) : ct(candle) {
+	PerformanceResults::PerformanceResults(std::shared_ptr<CandleTags> candle, std::shared_ptr<const OutcomeGrid> grid) : ct(candle),
+		outcome(candle->candle.time(), candle->candle.close(), std::move(grid)) {
 
 		initTime = std::chrono::steady_clock::now();
 	}
 
+	bool PerformanceResults::settlePrimary() {
+		if (primarySettled || !outcome.primaryDone()) return false;
+
+		OutcomeResult r = outcome.result();
+		winLoss = r.winLoss;
+		winLossPct = r.winLossPct;
+		timeToWin = r.timeToWin;
+		primarySettled = true;
+		return true;
+	}
+
+	void PerformanceResults::settle() { outcomes = outcome.results(); }
+
 }
\ No newline at end of file
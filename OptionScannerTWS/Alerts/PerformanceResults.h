@@ -6,6 +6,7 @@
 #include <ctime>
 
 #include "Candle.h"
+#include "OutcomeTracker.h"
 
 namespace Alerts {
 
@@ -17,7 +18,18 @@ namespace Alerts {
 		double winLossPct{ 0 };
 		int timeToWin{ 0 };
 
-		PerformanceResults(std::shared_ptr<CandleTags> candle);
+		// Fed by the alert's contract, guarded by its dataLock()
+		OutcomeTracker outcome;
+		// Every horizon, target and stop of the grid, filled when the alert settles
+		OutcomeMatrix outcomes;
+		bool primarySettled{ false };
+
+		PerformanceResults(std::shared_ptr<CandleTags> candle, std::shared_ptr<const OutcomeGrid> grid = OutcomeGrid::standard());
+
+		// Copies the tracker's primary cell into the fields posted to the db once it is final, true only the first time
+		bool settlePrimary();
+		// Copies the tracker's results into the matrix once every cell is final
+		void settle();
 	};
 
 }
\ No newline at end of file
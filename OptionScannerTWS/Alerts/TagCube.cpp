@@ -0,0 +1,136 @@
+#include "TagCube.h"
+
+#include <bitset>
+#include <cmath>
+
+namespace {
+	int popcount(uint64_t bits) { return static_cast<int>(std::bitset<64>(bits).count()); }
+}
+
+namespace Alerts {
+
+	size_t TagCube::add(TagWord tags, double win, double pctWon) {
+		size_t id = size_++;
+		size_t word = id / 64;
+		uint64_t bit = uint64_t(1) << (id % 64);
+
+		// A new word for every bitmap each 64 alerts
+		if (word == present_.size()) {
+			present_.push_back(0);
+			for (Bitmap& b : tagBits_) b.push_back(0);
+			fullWins_.push_back(0);
+			halfWins_.push_back(0);
+			wins_.push_back(0);
+			for (Bitmap& b : pctSlices_) b.push_back(0);
+		}
+
+		present_[word] |= bit;
+		for (size_t i = 0; i < kNumTagCategories; i++) tagBits_[tags.dbId(static_cast<TagCategory>(i)) - 1][word] |= bit;
+
+		if (win > 0) {
+			wins_[word] |= bit;
+			if (win >= 1) fullWins_[word] |= bit;
+			else halfWins_[word] |= bit;
+
+			long long hundredths = std::llround(pctWon * 100);
+			long long maxHundredths = (1LL << kPctSlices) - 1;
+			if (hundredths < 0) hundredths = 0;
+			if (hundredths > maxHundredths) hundredths = maxHundredths;
+			for (int k = 0; k < kPctSlices; k++) {
+				if ((hundredths >> k) & 1) pctSlices_[k][word] |= bit;
+			}
+		}
+
+		return id;
+	}
+
+	size_t TagCube::add(const AlertTags& tags, double win, double pctWon) { return add(tags.word(), win, pctWon); }
+
+	void TagCube::reserve(size_t alerts) {
+		size_t words = (alerts + 63) / 64;
+		present_.reserve(words);
+		for (Bitmap& b : tagBits_) b.reserve(words);
+		fullWins_.reserve(words);
+		halfWins_.reserve(words);
+		wins_.reserve(words);
+		for (Bitmap& b : pctSlices_) b.reserve(words);
+	}
+
+	size_t TagCube::size() const { return size_; }
+
+	AlertStats TagCube::query(const CubeQuery& query) const {
+		Bitmap selected = present_;
+		TagWord values = query.values();
+
+		for (size_t i = 0; i < kNumTagCategories; i++) {
+			TagCategory category = static_cast<TagCategory>(i);
+			if (!query.has(category)) continue;
+
+			const Bitmap& tag = tagBits_[values.dbId(category) - 1];
+			for (size_t w = 0; w < selected.size(); w++) selected[w] &= tag[w];
+		}
+
+		return aggregate(selected);
+	}
+
+	std::vector<std::pair<TagWord, AlertStats>> TagCube::rollUp(const std::vector<TagCategory>& categories) const {
+		std::vector<std::pair<TagWord, AlertStats>> out;
+		rollUp(categories, 0, present_, TagWord(), out);
+		return out;
+	}
+
+	void TagCube::rollUp(const std::vector<TagCategory>& categories, size_t depth, const Bitmap& selected, TagWord tags,
+		std::vector<std::pair<TagWord, AlertStats>>& out) const {
+
+		if (depth == categories.size()) {
+			AlertStats stats = aggregate(selected);
+			if (stats.totalAlerts() > 0) out.emplace_back(tags, stats);
+			return;
+		}
+
+		TagCategory category = categories[depth];
+		size_t i = TagFields::index(category);
+		Bitmap narrowed(selected.size());
+
+		for (int value = 0; value < kTagValues[i]; value++) {
+			const Bitmap& tag = tagBits_[TagFields::dbBase(i) - 1 + value];
+
+			uint64_t any = 0;
+			for (size_t w = 0; w < selected.size(); w++) {
+				narrowed[w] = selected[w] & tag[w];
+				any |= narrowed[w];
+			}
+			if (!any) continue;
+
+			rollUp(categories, depth + 1, narrowed, TagWord(tags).set(category, value), out);
+		}
+	}
+
+	AlertStats TagCube::aggregate(const Bitmap& selected) const {
+		long long total = 0;
+		long long fullWins = 0;
+		long long halfWins = 0;
+		long long wins = 0;
+		long long pctHundredths = 0;
+
+		for (size_t w = 0; w < selected.size(); w++) {
+			uint64_t m = selected[w];
+			if (!m) continue;
+
+			total += popcount(m);
+			fullWins += popcount(m & fullWins_[w]);
+			halfWins += popcount(m & halfWins_[w]);
+
+			uint64_t winners = m & wins_[w];
+			if (!winners) continue;
+			wins += popcount(winners);
+			for (int k = 0; k < kPctSlices; k++) pctHundredths += static_cast<long long>(popcount(winners & pctSlices_[k][w])) << k;
+		}
+
+		if (total == 0) return AlertStats();
+
+		double averageWin = wins > 0 ? (static_cast<double>(pctHundredths) / 100) / wins : 0;
+		return AlertStats(fullWins + 0.5 * halfWins, static_cast<double>(wins), static_cast<double>(total), averageWin);
+	}
+
+}
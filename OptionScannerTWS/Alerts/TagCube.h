@@ -0,0 +1,81 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Tag statistics cube
+// Every alert gets an id, its position in the cube, and each tag value
+// keeps a bitmap of the ids holding it. Outcomes are bitmaps as well:
+// full wins, half wins, any win, and the winning percent in hundredths
+// sliced one bit per bitmap. A query over any subset of tag categories
+// ANDs one bitmap per chosen category and counts bits, so win rate and
+// average win come from popcounts alone without touching each alert.
+// Roll ups narrow the bitmap one category at a time and skip values
+// with no alerts
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "AlertTags.h"
+
+namespace Alerts {
+
+	// Tag values to filter on, categories left out are rolled up
+	class CubeQuery {
+	public:
+		template <typename E>
+		CubeQuery& where(TagCategory category, E value) {
+			values_.set(category, value);
+			dims_ |= 1u << TagFields::index(category);
+			return *this;
+		}
+
+		bool has(TagCategory category) const { return (dims_ >> TagFields::index(category)) & 1u; }
+		TagWord values() const { return values_; }
+
+	private:
+		TagWord values_;
+		uint32_t dims_{ 0 };
+	};
+
+	class TagCube {
+	public:
+		// Win is 0, 0.5 or 1 as in AlertStats, returns the alert's id
+		size_t add(TagWord tags, double win, double pctWon);
+		size_t add(const AlertTags& tags, double win, double pctWon);
+		void reserve(size_t alerts);
+		size_t size() const;
+
+		AlertStats query(const CubeQuery& query) const;
+
+		// Stats for each combination of values of the given categories that has any alerts
+		// Categories left out are zero in the returned words
+		std::vector<std::pair<TagWord, AlertStats>> rollUp(const std::vector<TagCategory>& categories) const;
+
+		// Winning percents are kept in hundredths over this many slices, larger values are clamped
+		static constexpr int kPctSlices = 20;
+
+	private:
+		using Bitmap = std::vector<uint64_t>;
+
+		AlertStats aggregate(const Bitmap& selected) const;
+		void rollUp(const std::vector<TagCategory>& categories, size_t depth, const Bitmap& selected, TagWord tags,
+			std::vector<std::pair<TagWord, AlertStats>>& out) const;
+
+		size_t size_{ 0 };
+
+		// Every id in the cube, then one bitmap per tag value laid out like the AlertTags table ids
+		Bitmap present_;
+		Bitmap tagBits_[TagFields::kNumDbIds];
+
+		// Outcomes, pctSlices_[k] holds bit k of each winner's percent in hundredths
+		Bitmap fullWins_;
+		Bitmap halfWins_;
+		Bitmap wins_;
+		Bitmap pctSlices_[kPctSlices];
+	};
+
+}
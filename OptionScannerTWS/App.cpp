@@ -1,8 +1,10 @@
 #include "App.h"
 
-App::App(const char* host) : host(host), YW(23, false) {
+App::App(const char* host) : host(host), YW(true) {
 
     // Initialize connection
+    // The TwsApiC++ EReader thread blocks on the socket and dispatches every callback as frames arrive,
+    // so there is no need to poll checkMessages from our own thread
     EC = EClientL0::New(&YW);
     // Connect to TWS
     EC->eConnect(host, 7496, 0);
@@ -11,8 +13,9 @@ App::App(const char* host) : host(host), YW(23, false) {
     //          Here we will start with a simple request for the TWS current time and wait
     // ** Also note that this will return time in Unix form for the current time zone of the server hosting tws
     EC->reqCurrentTime();
-    std::this_thread::sleep_for(std::chrono::milliseconds(10));
-    EC->checkMessages();
+    for (int i = 0; i < 100 && YW.getCurrentTime() == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
     
     std::cout << YW.getCurrentTime() << std::endl;
 
@@ -25,4 +28,29 @@ App::~App() {
     EC->eDisconnect();
     delete EC;
 
-}
\ No newline at end of file
+}
+
+//====================================================
+// One shot requests returning futures
+//====================================================
+
+std::future<MarketSnapshot> App::requestSnapshot(TickerId reqId, const Contract& contract, const IBString& genericTicks) {
+    std::future<MarketSnapshot> f = YW.requests().expectSnapshot(reqId);
+    EC->reqMktData(reqId, contract, genericTicks, true);
+    return f;
+}
+
+std::future<std::vector<std::unique_ptr<Candle>>> App::requestHistoricalData(TickerId reqId, const Contract& contract,
+    const IBString& endDateTime, const IBString& durationStr, const IBString& barSizeSetting,
+    const IBString& whatToShow, int useRTH) {
+
+    std::future<std::vector<std::unique_ptr<Candle>>> f = YW.requests().expectHistoricalData(reqId);
+    EC->reqHistoricalData(reqId, contract, endDateTime, durationStr, barSizeSetting, whatToShow, useRTH, FormatDate::AsDate, false);
+    return f;
+}
+
+std::future<std::vector<ContractDetails>> App::requestContractDetails(int reqId, const Contract& contract) {
+    std::future<std::vector<ContractDetails>> f = YW.requests().expectContractDetails(reqId);
+    EC->reqContractDetails(reqId, contract);
+    return f;
+}
@@ -10,6 +10,7 @@
 #include <ctime>
 #include <cstdlib>
 #include <memory>
+#include <future>
 
 #include "tWrapper.h"
 #include "DatabaseManager.h"
@@ -25,6 +26,13 @@ public:
 	App(const char* host);
 	~App();
 
+	// One shot requests, the future is registered with the wrapper before the request is sent
+	std::future<MarketSnapshot> requestSnapshot(TickerId reqId, const Contract& contract, const IBString& genericTicks = "");
+	std::future<std::vector<std::unique_ptr<Candle>>> requestHistoricalData(TickerId reqId, const Contract& contract,
+		const IBString& endDateTime, const IBString& durationStr, const IBString& barSizeSetting,
+		const IBString& whatToShow = *WhatToShow::TRADES, int useRTH = UseRTH::OnlyRegularTradingData);
+	std::future<std::vector<ContractDetails>> requestContractDetails(int reqId, const Contract& contract);
+
 public:
 	EClientL0* EC;
 	tWrapper YW;
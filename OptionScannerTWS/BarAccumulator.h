@@ -0,0 +1,66 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Running OHLCV bar
+// Folds each incoming bar into the one being built in O(1). The bar is
+// sealed by the owner once it has seen enough bars for its timeframe,
+// and can be read at any point before that as a partially formed bar
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+
+#include "Candle.h"
+
+// Open of the first bar, close and time of the last, extremes and total volume in between
+struct BarSummary {
+    long time{ 0 };
+    double open{ 0 };
+    double high{ 0 };
+    double low{ 0 };
+    double close{ 0 };
+    long volume{ 0 };
+};
+
+class BarAccumulator {
+public:
+    void add(const Candle& c) {
+        if (count_ == 0) {
+            bar_.open = c.open();
+            bar_.high = c.high();
+            bar_.low = c.low();
+            bar_.volume = 0;
+        }
+        else {
+            bar_.high = c.high() > bar_.high ? c.high() : bar_.high;
+            bar_.low = c.low() < bar_.low ? c.low() : bar_.low;
+        }
+
+        bar_.close = c.close();
+        bar_.time = c.time();
+        bar_.volume += c.volume();
+        slot_ = c.slot();
+        count_++;
+    }
+
+    // Number of bars folded in since the last seal
+    size_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    // Bar so far, time is that of the newest bar added
+    const BarSummary& bar() const { return bar_; }
+    int slot() const { return slot_; }
+
+    BarSummary seal() {
+        BarSummary sealed = bar_;
+        count_ = 0;
+        bar_ = BarSummary();
+        return sealed;
+    }
+
+private:
+    BarSummary bar_;
+    size_t count_{ 0 };
+    int slot_{ -1 };
+};
@@ -0,0 +1,269 @@
+#include "CallbackJournal.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char kJournalMagic[8] = { 'O', 'S', 'J', 'R', 'N', 'L', '0', '1' };
+    constexpr uint32_t kJournalVersion = 1;
+
+    int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    size_t fileBytes(size_t records) { return sizeof(JournalHeader) + records * sizeof(JournalRecord); }
+
+#ifndef _WIN32
+    // Descriptors are stored offset by one so that a null handle always means closed
+    int fdOf(void* handle) { return static_cast<int>(reinterpret_cast<intptr_t>(handle)) - 1; }
+    void* handleOf(int fd) { return reinterpret_cast<void*>(static_cast<intptr_t>(fd) + 1); }
+#endif
+}
+
+//====================================================
+// Journal Writer
+//====================================================
+
+JournalWriter::JournalWriter(const std::string& path, size_t recordsPerChunk) :
+    path_(path), recordsPerChunk_(recordsPerChunk > 0 ? recordsPerChunk : 1) {
+
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) throw std::runtime_error("Unable to create journal " + path);
+    file_ = h;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw std::runtime_error("Unable to create journal " + path);
+    file_ = handleOf(fd);
+#endif
+
+    open_ = true;
+    try {
+        map(recordsPerChunk_);
+    }
+    catch (...) {
+        close(); // The destructor won't run, so the file handle is released here
+        throw;
+    }
+
+    JournalHeader* header = reinterpret_cast<JournalHeader*>(base_);
+    std::memset(header, 0, sizeof(JournalHeader));
+    std::memcpy(header->magic, kJournalMagic, sizeof(kJournalMagic));
+    header->version = kJournalVersion;
+    header->recordSize = sizeof(JournalRecord);
+}
+
+JournalWriter::~JournalWriter() { close(); }
+
+void JournalWriter::appendRealtimeBar(TickerId reqId, long time, double open, double high, double low, double close,
+    long volume, double wap, int count) {
+
+    JournalRecord& r = next(JournalRecordType::RealtimeBar, reqId);
+    r.payload.bar.time = time;
+    r.payload.bar.open = open;
+    r.payload.bar.high = high;
+    r.payload.bar.low = low;
+    r.payload.bar.close = close;
+    r.payload.bar.wap = wap;
+    r.payload.bar.volume = volume;
+    r.payload.bar.count = count;
+    commit();
+}
+
+void JournalWriter::appendTickPrice(TickerId reqId, int field, double price, int canAutoExecute) {
+    JournalRecord& r = next(JournalRecordType::TickPrice, reqId);
+    r.payload.tick.field = field;
+    r.payload.tick.canAutoExecute = canAutoExecute;
+    r.payload.tick.price = price;
+    commit();
+}
+
+void JournalWriter::appendTickSize(TickerId reqId, int field, int size) {
+    JournalRecord& r = next(JournalRecordType::TickSize, reqId);
+    r.payload.size.field = field;
+    r.payload.size.size = size;
+    commit();
+}
+
+void JournalWriter::appendError(int id, int errorCode, const char* message) {
+    JournalRecord& r = next(JournalRecordType::Error, id);
+    r.payload.error.code = errorCode;
+    std::strncpy(r.payload.error.message, message ? message : "", sizeof(r.payload.error.message) - 1);
+    commit();
+}
+
+void JournalWriter::appendTickString(TickerId reqId, int field, const char* value) {
+    JournalRecord& r = next(JournalRecordType::TickString, reqId);
+    r.payload.string.field = field;
+    std::strncpy(r.payload.string.value, value ? value : "", sizeof(r.payload.string.value) - 1);
+    commit();
+}
+
+void JournalWriter::close() {
+    if (!open_) return;
+    open_ = false;
+
+    unmap();
+
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(fileBytes(static_cast<size_t>(count_)));
+    SetFilePointerEx(static_cast<HANDLE>(file_), size, NULL, FILE_BEGIN);
+    SetEndOfFile(static_cast<HANDLE>(file_));
+    CloseHandle(static_cast<HANDLE>(file_));
+#else
+    if (ftruncate(fdOf(file_), static_cast<off_t>(fileBytes(static_cast<size_t>(count_)))) != 0) {
+        // Leaving the unused tail is harmless, the reader trusts the header count
+    }
+    ::close(fdOf(file_));
+#endif
+
+    file_ = nullptr;
+}
+
+uint64_t JournalWriter::count() const { return count_; }
+const std::string& JournalWriter::path() const { return path_; }
+
+JournalRecord& JournalWriter::next(JournalRecordType type, TickerId reqId) {
+    if (count_ >= capacity_) map(capacity_ + recordsPerChunk_);
+
+    JournalRecord& r = reinterpret_cast<JournalRecord*>(base_ + sizeof(JournalHeader))[count_];
+    std::memset(&r, 0, sizeof(JournalRecord));
+    r.recvNs = nowNs();
+    r.type = type;
+    r.reqId = static_cast<int32_t>(reqId);
+    return r;
+}
+
+void JournalWriter::commit() {
+    count_++;
+    reinterpret_cast<JournalHeader*>(base_)->count = count_;
+}
+
+void JournalWriter::map(size_t capacity) {
+    unmap();
+    size_t bytes = fileBytes(capacity);
+
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(bytes);
+    HANDLE m = CreateFileMappingA(static_cast<HANDLE>(file_), NULL, PAGE_READWRITE, size.HighPart, size.LowPart, NULL);
+    if (m == NULL) throw std::runtime_error("Unable to map journal " + path_);
+    base_ = static_cast<char*>(MapViewOfFile(m, FILE_MAP_WRITE, 0, 0, bytes));
+    if (!base_) CloseHandle(m); // unmap returns early without a view, so the handle is closed here
+    else mapping_ = m;
+#else
+    if (ftruncate(fdOf(file_), static_cast<off_t>(bytes)) != 0) throw std::runtime_error("Unable to grow journal " + path_);
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fdOf(file_), 0);
+    base_ = (p == MAP_FAILED) ? nullptr : static_cast<char*>(p);
+#endif
+
+    if (!base_) throw std::runtime_error("Unable to map journal " + path_);
+    capacity_ = capacity;
+}
+
+void JournalWriter::unmap() {
+    if (!base_) return;
+
+#ifdef _WIN32
+    FlushViewOfFile(base_, 0);
+    UnmapViewOfFile(base_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(base_, fileBytes(capacity_));
+#endif
+
+    base_ = nullptr;
+}
+
+//====================================================
+// Journal Reader
+//====================================================
+
+JournalReader::JournalReader(const std::string& path) {
+    // The destructor won't run if the constructor throws, so release whatever was opened so far
+    try {
+        open(path);
+    }
+    catch (...) {
+        release();
+        throw;
+    }
+}
+
+JournalReader::~JournalReader() { release(); }
+
+void JournalReader::open(const std::string& path) {
+
+#ifdef _WIN32
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (h == INVALID_HANDLE_VALUE) throw std::runtime_error("Unable to open journal " + path);
+    file_ = h;
+
+    LARGE_INTEGER size;
+    GetFileSizeEx(h, &size);
+    fileSize_ = static_cast<size_t>(size.QuadPart);
+    if (fileSize_ < sizeof(JournalHeader)) throw std::runtime_error("Journal too small " + path);
+
+    HANDLE m = CreateFileMappingA(h, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (m == NULL) throw std::runtime_error("Unable to map journal " + path);
+    mapping_ = m;
+    base_ = static_cast<const char*>(MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0));
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("Unable to open journal " + path);
+    file_ = handleOf(fd);
+
+    struct stat st;
+    fstat(fd, &st);
+    fileSize_ = static_cast<size_t>(st.st_size);
+    if (fileSize_ < sizeof(JournalHeader)) throw std::runtime_error("Journal too small " + path);
+
+    void* p = mmap(nullptr, fileSize_, PROT_READ, MAP_SHARED, fd, 0);
+    base_ = (p == MAP_FAILED) ? nullptr : static_cast<const char*>(p);
+#endif
+
+    if (!base_) throw std::runtime_error("Unable to map journal " + path);
+
+    const JournalHeader* header = reinterpret_cast<const JournalHeader*>(base_);
+    if (std::memcmp(header->magic, kJournalMagic, sizeof(kJournalMagic)) != 0 || header->recordSize != sizeof(JournalRecord)) {
+        throw std::runtime_error("Not a callback journal " + path);
+    }
+
+    // Trust the header, but never read past the end of the file
+    size_t available = (fileSize_ - sizeof(JournalHeader)) / sizeof(JournalRecord);
+    count_ = static_cast<size_t>(header->count) < available ? static_cast<size_t>(header->count) : available;
+}
+
+void JournalReader::release() {
+#ifdef _WIN32
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+#else
+    if (base_) munmap(const_cast<char*>(base_), fileSize_);
+    if (file_) ::close(fdOf(file_));
+#endif
+
+    base_ = nullptr;
+    mapping_ = nullptr;
+    file_ = nullptr;
+}
+
+size_t JournalReader::size() const { return count_; }
+const JournalRecord& JournalReader::operator[](size_t i) const { return begin()[i]; }
+const JournalRecord* JournalReader::begin() const { return reinterpret_cast<const JournalRecord*>(base_ + sizeof(JournalHeader)); }
+const JournalRecord* JournalReader::end() const { return begin() + count_; }
@@ -0,0 +1,229 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Binary journal of the raw TWS callback stream
+// Every recorded callback is written as one fixed size record with a
+// nanosecond receive timestamp into a memory-mapped file. The journal
+// can be replayed through any wrapper exposing the EWrapper callbacks,
+// either at the recorded pace, N times faster, or as fast as possible
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include "TwsApiL0.h"
+
+enum class JournalRecordType : uint8_t {
+    RealtimeBar = 1,
+    TickPrice = 2,
+    TickSize = 3,
+    Error = 4,
+    TickString = 5
+};
+
+struct JournalBar {
+    int64_t time;
+    double open;
+    double high;
+    double low;
+    double close;
+    double wap;
+    int64_t volume;
+    int32_t count;
+    int32_t reserved;
+};
+
+struct JournalTick {
+    int32_t field;
+    int32_t canAutoExecute;
+    double price;
+};
+
+struct JournalSize {
+    int32_t field;
+    int32_t size;
+};
+
+struct JournalError {
+    int32_t code;
+    char message[60]; // Truncated, always null terminated
+};
+
+struct JournalString {
+    int32_t field;
+    char value[60]; // RT_VOLUME strings fit comfortably, always null terminated
+};
+
+struct JournalRecord {
+    int64_t recvNs; // Wall clock receive time in nanoseconds since the epoch
+    JournalRecordType type;
+    uint8_t reserved[3];
+    int32_t reqId;
+
+    union {
+        JournalBar bar;
+        JournalTick tick;
+        JournalSize size;
+        JournalError error;
+        JournalString string;
+    } payload;
+};
+
+static_assert(sizeof(JournalRecord) == 80, "Journal records must stay fixed size");
+
+struct JournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t count; // Updated after every append so a crashed session is still readable
+    uint64_t reserved[5];
+};
+
+static_assert(sizeof(JournalHeader) == 64, "Journal header must stay fixed size");
+
+//=======================================================================
+// Writer, appends are expected from a single thread (the EReader)
+//=======================================================================
+
+class JournalWriter {
+public:
+    JournalWriter(const std::string& path, size_t recordsPerChunk = 1 << 20);
+    ~JournalWriter();
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    void appendRealtimeBar(TickerId reqId, long time, double open, double high, double low, double close,
+        long volume, double wap, int count);
+    void appendTickPrice(TickerId reqId, int field, double price, int canAutoExecute);
+    void appendTickSize(TickerId reqId, int field, int size);
+    void appendError(int id, int errorCode, const char* message);
+    void appendTickString(TickerId reqId, int field, const char* value);
+
+    // Flushes the header and trims the file to the records written
+    void close();
+
+    uint64_t count() const;
+    const std::string& path() const;
+
+private:
+    JournalRecord& next(JournalRecordType type, TickerId reqId);
+    void commit();
+    void map(size_t capacity);
+    void unmap();
+
+    std::string path_;
+    size_t recordsPerChunk_;
+    size_t capacity_{ 0 };
+    uint64_t count_{ 0 };
+
+    char* base_{ nullptr };
+    void* file_{ nullptr };    // HANDLE on Windows, file descriptor otherwise
+    void* mapping_{ nullptr }; // HANDLE to the file mapping on Windows
+    bool open_{ false };
+};
+
+//=======================================================================
+// Reader, maps an existing journal read only
+//=======================================================================
+
+class JournalReader {
+public:
+    explicit JournalReader(const std::string& path);
+    ~JournalReader();
+
+    JournalReader(const JournalReader&) = delete;
+    JournalReader& operator=(const JournalReader&) = delete;
+
+    size_t size() const;
+    const JournalRecord& operator[](size_t i) const;
+    const JournalRecord* begin() const;
+    const JournalRecord* end() const;
+
+private:
+    void open(const std::string& path);
+    void release();
+
+    const char* base_{ nullptr };
+    size_t fileSize_{ 0 };
+    size_t count_{ 0 };
+
+    void* file_{ nullptr };
+    void* mapping_{ nullptr };
+};
+
+//=======================================================================
+// Replay driver
+// speed 1 keeps the recorded gaps, N plays N times faster and 0 or less
+// plays as fast as possible. Works with tWrapper or any mock that has
+// the same realtimeBar, tickPrice, tickSize, tickString and error callbacks
+//=======================================================================
+
+class JournalReplay {
+public:
+    JournalReplay(const JournalReader& reader, double speed = 1.0) : reader_(reader), speed_(speed) {}
+
+    // Accept decides per record whether to dispatch it, stop may be set from another thread
+    template <typename Wrapper, typename Accept>
+    size_t run(Wrapper& wrapper, Accept accept, const std::atomic<bool>* stop = nullptr) {
+        using Clock = std::chrono::steady_clock;
+        size_t dispatched = 0;
+        if (reader_.size() == 0) return dispatched;
+
+        const int64_t firstNs = reader_[0].recvNs;
+        const Clock::time_point start = Clock::now();
+
+        for (const JournalRecord& r : reader_) {
+            if (stop && stop->load(std::memory_order_relaxed)) break;
+            if (!accept(r)) continue;
+
+            if (speed_ > 0) {
+                auto offset = std::chrono::nanoseconds(static_cast<int64_t>((r.recvNs - firstNs) / speed_));
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<Clock::duration>(offset));
+            }
+
+            dispatch(wrapper, r);
+            dispatched++;
+        }
+
+        return dispatched;
+    }
+
+    template <typename Wrapper>
+    size_t run(Wrapper& wrapper, const std::atomic<bool>* stop = nullptr) {
+        return run(wrapper, [](const JournalRecord&) { return true; }, stop);
+    }
+
+    template <typename Wrapper>
+    static void dispatch(Wrapper& wrapper, const JournalRecord& r) {
+        switch (r.type)
+        {
+        case JournalRecordType::RealtimeBar:
+            wrapper.realtimeBar(r.reqId, static_cast<long>(r.payload.bar.time), r.payload.bar.open, r.payload.bar.high,
+                r.payload.bar.low, r.payload.bar.close, static_cast<long>(r.payload.bar.volume), r.payload.bar.wap, r.payload.bar.count);
+            break;
+        case JournalRecordType::TickPrice:
+            wrapper.tickPrice(r.reqId, static_cast<TickType>(r.payload.tick.field), r.payload.tick.price, r.payload.tick.canAutoExecute);
+            break;
+        case JournalRecordType::TickSize:
+            wrapper.tickSize(r.reqId, static_cast<TickType>(r.payload.size.field), r.payload.size.size);
+            break;
+        case JournalRecordType::Error:
+            wrapper.error(r.reqId, r.payload.error.code, IBString(r.payload.error.message));
+            break;
+        case JournalRecordType::TickString:
+            wrapper.tickString(r.reqId, static_cast<TickType>(r.payload.string.field), IBString(r.payload.string.value));
+            break;
+        }
+    }
+
+private:
+    const JournalReader& reader_;
+    double speed_;
+};
@@ -26,12 +26,17 @@ Candle::Candle(TickerId reqId, long time, double open, double high,
     : reqId_(reqId), date_(""), time_(time), open_(open), close_(close), high_(high), 
     low_(low), volume_(volume), barCount_(0), WAP_(0.0), hasGaps_(0), count_(0) {}
 
+Candle::Candle(const RealtimeBar& bar)
+    : reqId_(bar.reqId), date_(""), time_(static_cast<long>(bar.time)), open_(bar.openPrice()), close_(bar.closePrice()),
+    high_(bar.highPrice()), low_(bar.lowPrice()), volume_(bar.volume), barCount_(0), WAP_(0.0), hasGaps_(0), count_(0),
+    slot_(bar.slot) {}
+
 Candle::Candle() : reqId_(0), date_(""), time_(0), open_(0), close_(0), high_(0),
     low_(0), volume_(0), barCount_(0), WAP_(0.0), hasGaps_(0), count_(0) {}
 
 Candle::Candle(const Candle& c) : reqId_(c.reqId_), date_(c.date_), dateConverted_(c.dateConverted_),
 time_(c.time_), open_(c.open_), close_(c.close_), high_(c.high_), low_(c.low_), volume_(c.volume_),
-barCount_(c.barCount_), WAP_(c.WAP_), hasGaps_(c.hasGaps_), count_(c.count_) {}
+barCount_(c.barCount_), WAP_(c.WAP_), hasGaps_(c.hasGaps_), count_(c.count_), slot_(c.slot_) {}
 
 // Getters
 TickerId Candle::reqId() const { return reqId_; }
@@ -45,6 +50,13 @@ int Candle::barCount() const { return barCount_; }
 double Candle::WAP() const { return WAP_; }
 int Candle::hasGaps() const { return hasGaps_; }
 int Candle::count() const { return count_; }
+int Candle::slot() const { return slot_; }
+
+void Candle::setSlot(int slot) { slot_ = slot; }
+
+RealtimeBar Candle::toRealtimeBar() const {
+    return RealtimeBar::make(reqId_, time_, open_, high_, low_, close_, volume_, slot_);
+}
 
 IBString Candle::date() const {
     if (!dateConverted_) {
@@ -78,59 +90,48 @@ void Candle::convertUnixToDate() const {
 
 CandleTags::CandleTags(std::shared_ptr<Candle> c, TimeFrame tf, Alerts::OptionType optType, Alerts::TimeOfDay tod,
     Alerts::VolumeStDev volStDev, Alerts::VolumeThreshold volThresh, Alerts::PriceDelta optPriceDelta,
-    Alerts::DailyHighsAndLows optDHL, Alerts::LocalHighsAndLows optLHL) :
-    candle(*c), tf_(tf), optType_(optType), tod_(tod), optPriceDelta_(optPriceDelta),
-    volStDev_(volStDev), volThresh_(volThresh), optDHL_(optDHL), optLHL_(optLHL) {}
+    Alerts::DailyHighsAndLows optDHL, Alerts::LocalHighsAndLows optLHL) : candle(*c)
+{
+    tags_.set(Alerts::TagCategory::TimeFrame, tf)
+        .set(Alerts::TagCategory::OptionType, optType)
+        .set(Alerts::TagCategory::TimeOfDay, tod)
+        .set(Alerts::TagCategory::VolumeStDev, volStDev)
+        .set(Alerts::TagCategory::VolumeThreshold, volThresh)
+        .set(Alerts::TagCategory::OptionPriceDelta, optPriceDelta)
+        .set(Alerts::TagCategory::OptionDailyHighsAndLows, optDHL)
+        .set(Alerts::TagCategory::OptionLocalHighsAndLows, optLHL)
+        .set(Alerts::TagCategory::RelativeToMoney, Alerts::RelativeToMoney::ATM)
+        .set(Alerts::TagCategory::UnderlyingDailyHighsAndLows, Alerts::DailyHighsAndLows::Inside)
+        .set(Alerts::TagCategory::UnderlyingLocalHighsAndLows, Alerts::LocalHighsAndLows::Inside);
+}
 
-CandleTags::CandleTags(std::shared_ptr<Candle> c, std::vector<int> tags) : candle(*c), tags_(tags)
+CandleTags::CandleTags(std::shared_ptr<Candle> c, std::vector<int> tags) : candle(*c)
 {
-    std::string tf = Alerts::TagDBInterface::intToTag[tags[0]].first;
-    std::string opttype = Alerts::TagDBInterface::intToTag[tags[1]].first;
-    std::string tod = Alerts::TagDBInterface::intToTag[tags[2]].first;
-    std::string rtm = Alerts::TagDBInterface::intToTag[tags[3]].first;
-    std::string volstdev = Alerts::TagDBInterface::intToTag[tags[4]].first;
-    std::string volthresh = Alerts::TagDBInterface::intToTag[tags[5]].first;
-    std::string priceDelta = Alerts::TagDBInterface::intToTag[tags[6]].first;
-    std::string opt_dhl = Alerts::TagDBInterface::intToTag[tags[7]].first;
-    std::string opt_lhl = Alerts::TagDBInterface::intToTag[tags[8]].first;
-    std::string underlyingPriceDelta = Alerts::TagDBInterface::intToTag[tags[9]].first;
-    std::string u_dhl = Alerts::TagDBInterface::intToTag[tags[10]].first;
-    std::string u_lhl = Alerts::TagDBInterface::intToTag[tags[11]].first;
-
-    tf_ = str_to_tf(tf);
-    optType_ = Alerts::EnumString::str_to_option_type(opttype);
-    tod_ = Alerts::EnumString::str_to_tod(tod);
-    rtm_ = Alerts::EnumString::str_to_rtm(rtm);
-    volStDev_ = Alerts::EnumString::str_to_vol_stdev(volstdev);
-    volThresh_ = Alerts::EnumString::str_to_vol_thresh(volthresh);
-    optPriceDelta_ = Alerts::EnumString::str_to_price_delta(priceDelta);
-    optDHL_ = Alerts::EnumString::str_to_daily_hl(opt_dhl);
-    optLHL_ = Alerts::EnumString::str_to_local_hl(opt_lhl);
-    underlyingPriceDelta_ = Alerts::EnumString::str_to_price_delta(underlyingPriceDelta);
-    underlyingDHL_ = Alerts::EnumString::str_to_daily_hl(u_dhl);
-    underlyingLHL_ = Alerts::EnumString::str_to_local_hl(u_lhl);
+    // Each table id belongs to exactly one category, so the position in the vector doesn't matter
+    for (int id : tags) tags_.setDbId(id);
 }
 
 void CandleTags::setSqlId(int val) { sqlId = val; }
 
 void CandleTags::addUnderlyingTags(Alerts::RelativeToMoney rtm, Alerts::PriceDelta pd, Alerts::DailyHighsAndLows DHL, Alerts::LocalHighsAndLows LHL) {
-    rtm_ = rtm;
-    underlyingPriceDelta_ = pd;
-    underlyingDHL_ = DHL;
-    underlyingLHL_ = LHL;
+    tags_.set(Alerts::TagCategory::RelativeToMoney, rtm)
+        .set(Alerts::TagCategory::UnderlyingPriceDelta, pd)
+        .set(Alerts::TagCategory::UnderlyingDailyHighsAndLows, DHL)
+        .set(Alerts::TagCategory::UnderlyingLocalHighsAndLows, LHL);
 }
 
 // Accessors
 int CandleTags::getSqlId() const { return sqlId; }
-TimeFrame CandleTags::getTimeFrame() const { return tf_; }
-Alerts::OptionType CandleTags::getOptType() const { return optType_; }
-Alerts::TimeOfDay CandleTags::getTOD() const { return tod_; }
-Alerts::RelativeToMoney CandleTags::getRTM() const { return rtm_; }
-Alerts::VolumeStDev CandleTags::getVolStDev() const { return volStDev_; }
-Alerts::VolumeThreshold CandleTags::getVolThresh() const { return volThresh_; }
-Alerts::PriceDelta CandleTags::getOptPriceDelta() const { return optPriceDelta_; }
-Alerts::DailyHighsAndLows CandleTags::getDHL() const { return optDHL_; }
-Alerts::LocalHighsAndLows CandleTags::getLHL() const { return optLHL_; }
-Alerts::PriceDelta CandleTags::getUnderlyingPriceDelta() const { return underlyingPriceDelta_; }
-Alerts::DailyHighsAndLows CandleTags::getUnderlyingDHL() const { return underlyingDHL_; }
-Alerts::LocalHighsAndLows CandleTags::getUnderlyingLHL() const { return underlyingLHL_; }
\ No newline at end of file
+TimeFrame CandleTags::getTimeFrame() const { return tags_.get<TimeFrame>(Alerts::TagCategory::TimeFrame); }
+Alerts::OptionType CandleTags::getOptType() const { return tags_.get<Alerts::OptionType>(Alerts::TagCategory::OptionType); }
+Alerts::TimeOfDay CandleTags::getTOD() const { return tags_.get<Alerts::TimeOfDay>(Alerts::TagCategory::TimeOfDay); }
+Alerts::RelativeToMoney CandleTags::getRTM() const { return tags_.get<Alerts::RelativeToMoney>(Alerts::TagCategory::RelativeToMoney); }
+Alerts::VolumeStDev CandleTags::getVolStDev() const { return tags_.get<Alerts::VolumeStDev>(Alerts::TagCategory::VolumeStDev); }
+Alerts::VolumeThreshold CandleTags::getVolThresh() const { return tags_.get<Alerts::VolumeThreshold>(Alerts::TagCategory::VolumeThreshold); }
+Alerts::PriceDelta CandleTags::getOptPriceDelta() const { return tags_.get<Alerts::PriceDelta>(Alerts::TagCategory::OptionPriceDelta); }
+Alerts::DailyHighsAndLows CandleTags::getDHL() const { return tags_.get<Alerts::DailyHighsAndLows>(Alerts::TagCategory::OptionDailyHighsAndLows); }
+Alerts::LocalHighsAndLows CandleTags::getLHL() const { return tags_.get<Alerts::LocalHighsAndLows>(Alerts::TagCategory::OptionLocalHighsAndLows); }
+Alerts::PriceDelta CandleTags::getUnderlyingPriceDelta() const { return tags_.get<Alerts::PriceDelta>(Alerts::TagCategory::UnderlyingPriceDelta); }
+Alerts::DailyHighsAndLows CandleTags::getUnderlyingDHL() const { return tags_.get<Alerts::DailyHighsAndLows>(Alerts::TagCategory::UnderlyingDailyHighsAndLows); }
+Alerts::LocalHighsAndLows CandleTags::getUnderlyingLHL() const { return tags_.get<Alerts::LocalHighsAndLows>(Alerts::TagCategory::UnderlyingLocalHighsAndLows); }
+Alerts::TagWord CandleTags::tagWord() const { return tags_; }
\ No newline at end of file
@@ -13,6 +13,8 @@
 using namespace TwsApi; // for TwsApiDefs.h
 
 #include "Enums.h"
+#include "TagWord.h"
+#include "RealtimeBar.h"
 
 class Candle {
 public:
@@ -26,6 +28,9 @@ public:
     // Constructor for other candles created from 5 sec
     Candle(TickerId reqId, long time, double open, double high, double low, double close, long volume);
 
+    // Constructor for bars received through the ingest ring, keeps the bar's slot
+    explicit Candle(const RealtimeBar& bar);
+
     Candle();
 
     Candle(const Candle& c); // Copy constructor
@@ -43,6 +48,13 @@ public:
     int hasGaps() const;
     int count() const;
 
+    // Dense contract slot assigned by the ContractRegistry, -1 if the reqId was never registered
+    int slot() const;
+    void setSlot(int slot);
+
+    // Compact copy for the ingest ring, WAP and count are not carried
+    RealtimeBar toRealtimeBar() const;
+
     void convertDateToUnix();
     void convertUnixToDate() const; // Lazy conversion only upon request
     
@@ -60,6 +72,7 @@ private:
     double WAP_;
     int hasGaps_;
     int count_;
+    int slot_{ -1 };
 };
 
 // This will contain all tags available to be obtained upon the creation of a candle
@@ -71,7 +84,7 @@ public:
         Alerts::VolumeStDev volStDev, Alerts::VolumeThreshold volThresh, Alerts::PriceDelta optPriceDelta,
         Alerts::DailyHighsAndLows optDHL, Alerts::LocalHighsAndLows optLHL);
 
-    // Constructor if receiving db data
+    // Constructor if receiving db data, tags are AlertTags table ids in any order
     CandleTags(std::shared_ptr<Candle> c, std::vector<int> tags);
 
     void setSqlId(int val);
@@ -95,23 +108,12 @@ public:
     Alerts::DailyHighsAndLows getUnderlyingDHL() const;
     Alerts::LocalHighsAndLows getUnderlyingLHL() const;
 
+    // Packed form of every tag above, for keying stats and db ids
+    Alerts::TagWord tagWord() const;
+
 private:
-    std::vector<int> tags_{};
     int sqlId{ 0 };
 
-    TimeFrame tf_{ TimeFrame::FiveSecs };
-    Alerts::OptionType optType_{ Alerts::OptionType::Call };
-    Alerts::TimeOfDay tod_{ Alerts::TimeOfDay::Hour1 };
-
-    Alerts::VolumeStDev volStDev_{ Alerts::VolumeStDev::LowVol };
-    Alerts::VolumeThreshold volThresh_{ Alerts::VolumeThreshold::LowVol };
-    Alerts::PriceDelta optPriceDelta_{ Alerts::PriceDelta::Under1 };
-    Alerts::DailyHighsAndLows optDHL_{ Alerts::DailyHighsAndLows::Inside };
-    Alerts::LocalHighsAndLows optLHL_{ Alerts::LocalHighsAndLows::Inside };
-
-    // Tags that rely on underlying price data that will be updated after construction
-    Alerts::RelativeToMoney rtm_{ Alerts::RelativeToMoney::ATM };
-    Alerts::PriceDelta underlyingPriceDelta_{ Alerts::PriceDelta::Under1 };
-    Alerts::DailyHighsAndLows underlyingDHL_{ Alerts::DailyHighsAndLows::Inside };
-    Alerts::LocalHighsAndLows underlyingLHL_{ Alerts::LocalHighsAndLows::Inside };
+    // All tags packed in one word, underlying tags are filled in after construction
+    Alerts::TagWord tags_;
 };
\ No newline at end of file
@@ -2,7 +2,7 @@
 //#include "Logger.h"
 
 // Helper function to create new candles from time increments
-std::shared_ptr<Candle> createNewBars(int id, int increment, const vector<std::shared_ptr<Candle>> data) {
+std::shared_ptr<Candle> createNewBars(int id, int increment, const CandleView& data) {
 	// Need to get total volume, high and low, and the open and close prices
 	double open = data[data.size() - increment]->open();
 	double close = data[data.size() - 1]->close();
@@ -18,13 +18,14 @@ std::shared_ptr<Candle> createNewBars(int id, int increment, const vector<std::s
 		volume += data[i]->volume();
 	}
 
-	std::shared_ptr<Candle> candle = std::make_shared<Candle>(id, time, open, high, low, close, volume);
+	std::shared_ptr<Candle> candle = makePooled<Candle>(id, time, open, high, low, close, volume);
+	candle->setSlot(data[data.size() - 1]->slot());
 
 	return candle;
 }
 
 ContractData::ContractData(TickerId reqId) :
-	contractId_{ reqId }, dailyHigh_{ 0 }, dailyLow_{ 10000 }, localHigh_{ 0 }, localLow_{ 10000 }, tempHigh_{ 0 }, tempLow_{ 10000 }
+	contractId_{ reqId }, dailyHigh_{ 0 }, dailyLow_{ 0 }, localHigh_{ 0 }, localLow_{ 0 }
 {
 	if (reqId % 5 == 0) {
 		optType_ = Alerts::OptionType::Call;
@@ -36,13 +37,15 @@ ContractData::ContractData(TickerId reqId) :
 	}
 
 	VPT_.addReqId(reqId);
+	initSeries();
 }
 
 ContractData::ContractData(TickerId reqId, std::shared_ptr<OptionDB::DatabaseManager> dbm) : dbm_(dbm),
-contractId_{ reqId }, dailyHigh_{ 0 }, dailyLow_{ 10000 }, localHigh_{ 0 }, localLow_{ 10000 }, tempHigh_{ 0 }, tempLow_{ 10000 }
+contractId_{ reqId }, dailyHigh_{ 0 }, dailyLow_{ 0 }, localHigh_{ 0 }, localLow_{ 0 }
 {
 	isUnderlying_ = true;
 	setupDatabaseManager(dbm_);
+	initSeries();
 }
 
 // Initiate the SQL connection variable to add db insertion after each candle created
@@ -54,13 +57,24 @@ void ContractData::setupDatabaseManager(std::shared_ptr<OptionDB::DatabaseManage
 // The input data function will be called each time a new candle is received, and will be where we 
 // update each time series vector, stdev and mean. The chaining of if statements ensures that
 // each vector has enough values to fill the next timeframe
-void ContractData::updateData(std::unique_ptr<Candle> c) {
+void ContractData::updateData(std::shared_ptr<Candle> c) { update(std::move(c), nullptr); }
+
+void ContractData::updateData(std::shared_ptr<Candle> c, const FiveSecVerdict& verdict) {
+	if (sdVol_[TimeFrame::FiveSecs].baseline().kind != StatsBaseline::Kind::Session) {
+		throw std::logic_error("Contract " + std::to_string(contractId_) + " keeps its own 5 second stats and can't adopt a verdict");
+	}
+	update(std::move(c), &verdict);
+}
+
+void ContractData::update(std::shared_ptr<Candle> c, const FiveSecVerdict* verdict) {
 	//============================================================
 	// 5 Second Candle Options
 	// ===========================================================
-	// Switch to shared pointer
 	std::shared_ptr<Candle> fiveSec{ std::move(c) };
-	updateContainers(fiveSec, TimeFrame::FiveSecs);
+	if (verdict) adoptVerdict(fiveSec, *verdict);
+	else updateContainers(fiveSec, TimeFrame::FiveSecs);
+	accumulate(*fiveSec);
+	updateOutcomes(*fiveSec);
 
 	// Update time of day tag
 	updateTimeOfDay(fiveSec->time());
@@ -70,85 +84,85 @@ void ContractData::updateData(std::unique_ptr<Candle> c) {
 		dbm_->addToInsertionQueue(fiveSec, TimeFrame::FiveSecs);
 	}
 
-	// Update daily high and low values to check relative price
-	dailyHigh_ = max(dailyHigh_, fiveSec->high());
-	dailyLow_ = min(dailyLow_, fiveSec->low());
+	// Update daily high and low values to check relative price, starting from the first bar of the day
+	if (series_[TimeFrame::FiveSecs].totalPushed() == 1) {
+		dailyHigh_ = fiveSec->high();
+		dailyLow_ = fiveSec->low();
+	}
+	else {
+		dailyHigh_ = max(dailyHigh_, fiveSec->high());
+		dailyLow_ = min(dailyLow_, fiveSec->low());
+	}
+	updateLocalMinMax(fiveSec);
 
 	// Wait for the first 30 minutes before updating comparisons
-	if (fiveSecCandles_.size() >= 360) updateComparisons();
-
-	std::shared_ptr<CandleTags> fiveSecTags = std::make_shared<CandleTags>(fiveSec, TimeFrame::FiveSecs, optType_, tod_,
-		VPT_.volStDev5Sec, VPT_.volThresh5Sec, VPT_.priceDelta5Sec, DHL_, LHL_);
+	if (series_[TimeFrame::FiveSecs].totalPushed() >= 360) updateComparisons();
 
 	///////////////////////// 5 Second Alert Options ///////////////////////////////
 	// Only try and capture 5 second candles with large volume to avoid adding too much noise to the db
-	if (!isUnderlying_ && fiveSecTags->candle.volume() > 100) {
-		if (alert_) alert_(fiveSecTags);
+	// Skipped if the tick bars already raised this alert before the bar closed
+	if (!isUnderlying_ && alert_ && earlyAlertTime_ != fiveSec->time()) {
+		bool candidate = verdict ? verdict->candidate : fiveSec->volume() > 100 &&
+			isAlertCandidate(TimeFrame::FiveSecs, fiveSec->time(), fiveSec->close(), fiveSec->volume());
+		if (candidate) alert_(makeTags(fiveSec, TimeFrame::FiveSecs));
 	}
 
 	//=============================================================
-	// 30 Second Candle Options
+	// Higher Timeframe Candle Options
 	//=============================================================
 
-	if (fiveSecCandles_.size() % 6 == 0 && fiveSecCandles_.size() > 0) {
-		std::shared_ptr<Candle> thirtySec{ createNewBars(contractId_, 6, fiveSecCandles_) };
-		updateContainers(thirtySec, TimeFrame::ThirtySecs);
-
-		// Post to db
-		if (dbConnect && isUnderlying_) dbm_->addToInsertionQueue(thirtySec, TimeFrame::ThirtySecs);
-
-		///////////////////////// 30 Second Alert Options ///////////////////////////////
-		std::shared_ptr<CandleTags> thirtySecTags = std::make_shared<CandleTags>(thirtySec, TimeFrame::ThirtySecs, optType_, tod_,
-			VPT_.volStDev30Sec, VPT_.volThresh30Sec, VPT_.priceDelta30Sec, DHL_, LHL_);
+	// Each timeframe closes on a boundary of the one below, so once one is still open the rest are too
+	for (size_t i = 1; i < kNumTimeFrames; i++) {
+		if (bars_.at(i).count() < baseBarsIn(i)) break;
 
-		if (!isUnderlying_) {
-			if (alert_) alert_(thirtySecTags);
-		}
+		TimeFrame tf = tfAt(i);
+		std::shared_ptr<Candle> candle{ sealBar(bars_.at(i)) };
 
-		//=================================================================
-		// 1 Minute Candle Options
-		//=================================================================
+		if (tf == TimeFrame::OneMin) updateCumulativeVolume(candle);
+		updateContainers(candle, tf);
 
-		if (thirtySecCandles_.size() > 0 && thirtySecCandles_.size() % 2 == 0) {
-			std::shared_ptr<Candle> oneMin{ createNewBars(contractId_, 2, thirtySecCandles_) };
-			updateCumulativeVolume(oneMin);
-			updateContainers(oneMin, TimeFrame::OneMin);
-
-			// Post to db
-			if (dbConnect && isUnderlying_) dbm_->addToInsertionQueue(oneMin, TimeFrame::OneMin);
+		// Post to db
+		if (dbConnect && isUnderlying_) dbm_->addToInsertionQueue(candle, tf);
 
-			std::shared_ptr<CandleTags> oneMinTags = std::make_shared<CandleTags>(oneMin, TimeFrame::OneMin, optType_, tod_,
-				VPT_.volStDev1Min, VPT_.volThresh1Min, VPT_.priceDelta1Min, DHL_, LHL_);
+		///////////////////////// Alert Options ///////////////////////////////
+		if (!isUnderlying_ && alert_ && isAlertCandidate(tf, candle->time(), candle->close(), candle->volume())) {
+			alert_(makeTags(candle, tf));
+		}
+	}
+}
 
-			///////////////////////// 1 minute Alert Options ///////////////////////////////
-			if (!isUnderlying_) {
-				if (alert_) alert_(oneMinTags);
-			}
+void ContractData::updateTickBar(std::shared_ptr<Candle> c) {
+	long start = c->time() - (c->time() % 5);
 
-			//====================================================================
-			// 5 Minute Candle Options
-			//====================================================================
+	if (start != partialStart_) {
+		partialStart_ = start;
+		partialOpen_ = c->open();
+		partialHigh_ = c->high();
+		partialLow_ = c->low();
+		partialVolume_ = 0;
+	}
 
-			if (oneMinCandles_.size() > 0 && oneMinCandles_.size() % 5 == 0) {
-				std::shared_ptr<Candle> fiveMin{ createNewBars(contractId_, 5, oneMinCandles_) };
-				// Every 30 minutes, update the local high and low.
-				updateLocalMinMax(fiveMin);
-				updateContainers(fiveMin, TimeFrame::FiveMin);
+	partialHigh_ = max(partialHigh_, c->high());
+	partialLow_ = min(partialLow_, c->low());
+	partialClose_ = c->close();
+	partialVolume_ += c->volume();
 
-				// Post to db
-				if (dbConnect && isUnderlying_) dbm_->addToInsertionQueue(fiveMin, TimeFrame::FiveMin);
+	// Same volume gate as the 5 second alert, raised at most once per 5 second bar
+	if (isUnderlying_ || !alert_ || earlyAlertTime_ == start || partialVolume_ <= 100) return;
+	if (!isAlertCandidate(TimeFrame::FiveSecs, start, partialClose_, partialVolume_)) return;
+	earlyAlertTime_ = start;
 
-				std::shared_ptr<CandleTags> fiveMinTags = std::make_shared<CandleTags>(fiveMin, TimeFrame::FiveMin, optType_, tod_,
-					VPT_.volStDev5Min, VPT_.volThresh5Min, VPT_.priceDelta5Min, DHL_, LHL_);
+	std::shared_ptr<Candle> partial = makePooled<Candle>(contractId_, start, partialOpen_, partialHigh_, partialLow_, partialClose_, partialVolume_);
+	partial->setSlot(c->slot());
 
-				///////////////////////// 5 Minute Alert Options ///////////////////////////////
-				if (!isUnderlying_) {
-					if (alert_) alert_(fiveMinTags);
-				}
-			}
-		}
+	const TimeFrameTags& tags = VPT_.tags[TimeFrame::FiveSecs];
+	Alerts::VolumeStDev volStDev = tags.volStDev;
+	if (series_[TimeFrame::FiveSecs].totalPushed() >= tfSpec(TimeFrame::FiveSecs).warmup) {
+		volStDev = VPT_.updateVolStDev(sdVol_[TimeFrame::FiveSecs].numStDev(partialVolume_));
 	}
 
+	alert_(makePooled<CandleTags>(partial, TimeFrame::FiveSecs, optType_, tod_,
+		volStDev, VPT_.updateVolThreshold(partialVolume_), tags.priceDelta, DHL_, LHL_));
 }
 
 //===============================================
@@ -161,182 +175,246 @@ int ContractData::strikePrice() const { return strikePrice_; }
 Alerts::OptionType ContractData::optType() const { return optType_; }
 
 // Time series accessors
-vector<std::shared_ptr<Candle>> ContractData::fiveSecData() const { return fiveSecCandles_; }
-vector<std::shared_ptr<Candle>> ContractData::thirtySecData() const { return thirtySecCandles_; }
-vector<std::shared_ptr<Candle>> ContractData::oneMinData() const { return oneMinCandles_; }
-vector<std::shared_ptr<Candle>> ContractData::fiveMinData() const { return fiveMinCandles_; }
+CandleView ContractData::fiveSecData() const { return series_[TimeFrame::FiveSecs].view(); }
+CandleView ContractData::thirtySecData() const { return series_[TimeFrame::ThirtySecs].view(); }
+CandleView ContractData::oneMinData() const { return series_[TimeFrame::OneMin].view(); }
+CandleView ContractData::fiveMinData() const { return series_[TimeFrame::FiveMin].view(); }
+CandleView ContractData::data(TimeFrame tf) const { return series_[tf].view(); }
 
 // Other data acessors
-double ContractData::currentPrice() const { return fiveSecCandles_.back()->close(); }
+double ContractData::currentPrice() const { return series_[TimeFrame::FiveSecs].back()->close(); }
 double ContractData::dailyHigh() const { return dailyHigh_; }
 double ContractData::dailyLow() const { return dailyLow_; }
 double ContractData::localHigh() const { return localHigh_; }
 double ContractData::localLow() const { return localLow_; }
+
+void ContractData::setLocalWindow(size_t fiveSecBars) {
+	localHighs_.setWindow(fiveSecBars);
+	localLows_.setWindow(fiveSecBars);
+}
 long long ContractData::totalVol() const { return cumulativeVolume_.back().second; }
 
 vector<std::pair<long, long long>> ContractData::volOverTime() const { return cumulativeVolume_; }
 
 std::shared_ptr<Candle> ContractData::latestCandle(TimeFrame tf) {
-	switch (tf)
-	{
-	case TimeFrame::FiveSecs:
-		return fiveSecCandles_.back();
-	case TimeFrame::ThirtySecs:
-		return thirtySecCandles_.back();
-	case TimeFrame::OneMin:
-		return oneMinCandles_.back();
-	case TimeFrame::FiveMin:
-		return fiveMinCandles_.back();
-	default:
+	if (series_[tf].empty()) {
 		OPTIONSCANNER_ERROR("Failed to return most recent candle");
 		return {};
 	}
-}
 
-std::vector<std::shared_ptr<Candle>> ContractData::candlesLast30Minutes() {
-	vector<std::shared_ptr<Candle>> res;
+	return series_[tf].back();
+}
 
-	if (fiveSecCandles_.size() >= 360) {
-		for (size_t i = fiveSecCandles_.size() - 360; i < fiveSecCandles_.size(); i++) res.push_back(fiveSecCandles_[i]);
-	}
-	else {
-		res = {};
+CandleView ContractData::candlesLast30Minutes() {
+	const CandleSeries& fiveSec = series_[TimeFrame::FiveSecs];
+	if (fiveSec.size() < 360) {
 		OPTIONSCANNER_ERROR("Not enough five sec candles to return");
-	}
-
-	return res;
-}
-
-StandardDeviation ContractData::priceStDev(TimeFrame tf) {
-	switch (tf)
-	{
-	case TimeFrame::FiveSecs:
-		return sdPrice5Sec_;
-	case TimeFrame::ThirtySecs:
-		return sdPrice30Sec_;
-	case TimeFrame::OneMin:
-		return sdPrice1Min_;
-	case TimeFrame::FiveMin:
-		return sdPrice5Min_;
-	default:
-		OPTIONSCANNER_ERROR("Failed to return Price Standard Deviation Object");
 		return {};
 	}
+
+	return fiveSec.last(360);
 }
 
-StandardDeviation ContractData::volStDev(TimeFrame tf) {
-	switch (tf)
-	{
-	case TimeFrame::FiveSecs:
-		return sdVol5Sec_;
-	case TimeFrame::ThirtySecs:
-		return sdVol30Sec_;
-	case TimeFrame::OneMin:
-		return sdVol1Min_;
-	case TimeFrame::FiveMin:
-		return sdVol5Min_;
-	default:
-		OPTIONSCANNER_ERROR("Failed to return Volume Standard Deviation Object");
-		return {};
-	}
+std::unique_lock<std::mutex> ContractData::dataLock() { return std::unique_lock<std::mutex>(cdMtx); }
+
+std::shared_ptr<Candle> ContractData::partialBar(TimeFrame tf) {
+	std::lock_guard<std::mutex> lock(cdMtx);
+	if (tf == TimeFrame::FiveSecs) return series_[tf].empty() ? nullptr : series_[tf].back();
+
+	const BarAccumulator* acc = &bars_[tf];
+	if (!acc || acc->empty()) return nullptr;
+
+	const BarSummary& bar = acc->bar();
+	std::shared_ptr<Candle> candle = makePooled<Candle>(contractId_, bar.time, bar.open, bar.high, bar.low, bar.close, bar.volume);
+	candle->setSlot(acc->slot());
+	return candle;
 }
 
-Alerts::PriceDelta ContractData::priceDelta(TimeFrame tf) {
-	switch (tf)
-	{
-	case TimeFrame::FiveSecs:
-		return VPT_.priceDelta5Sec;
-	case TimeFrame::ThirtySecs:
-		return VPT_.priceDelta30Sec;
-	case TimeFrame::OneMin:
-		return VPT_.priceDelta1Min;
-	case TimeFrame::FiveMin:
-		return VPT_.priceDelta5Min;
-	default:
-		OPTIONSCANNER_ERROR("Failed to return Price Delta Object");
-		return {};
+void ContractData::setSeriesCapacity(TimeFrame tf, size_t capacity) {
+	std::lock_guard<std::mutex> lock(cdMtx);
+	series_[tf].setCapacity(max(capacity, tfSpec(tf).minCapacity));
+}
+
+size_t ContractData::seriesCapacity(TimeFrame tf) const { return series_[tf].capacity(); }
+
+StandardDeviation ContractData::priceStDev(TimeFrame tf) { return sdPrice_[tf]; }
+StandardDeviation ContractData::volStDev(TimeFrame tf) { return sdVol_[tf]; }
+
+void ContractData::setStatsBaseline(TimeFrame tf, StatsBaseline baseline) {
+	if (series_[TimeFrame::FiveSecs].totalPushed() > 0) {
+		throw std::logic_error("Stats baseline for " + std::to_string(contractId_) + " must be set before streaming starts");
 	}
+
+	sdPrice_[tf] = StandardDeviation(baseline);
+	sdVol_[tf] = StandardDeviation(baseline);
 }
 
+const StatsBaseline& ContractData::statsBaseline(TimeFrame tf) const { return sdVol_[tf].baseline(); }
+
+Alerts::PriceDelta ContractData::priceDelta(TimeFrame tf) { return VPT_.tags[tf].priceDelta; }
+
 Alerts::DailyHighsAndLows ContractData::dailyHLComparison() { return DHL_; }
 Alerts::LocalHighsAndLows ContractData::localHLComparison() { return LHL_; }
 
+UnderlyingSnapshot ContractData::snapshot() {
+	UnderlyingSnapshot snap;
+	if (series_[TimeFrame::FiveSecs].empty()) return snap;
+
+	snap.valid = true;
+	snap.price = currentPrice();
+	for (const TimeFrameSpec& spec : kTimeFrames) snap.priceDeltas[spec.tf] = VPT_.tags[spec.tf].priceDelta;
+	snap.DHL = DHL_;
+	snap.LHL = LHL_;
+
+	return snap;
+}
+
 //==============================================
-// Helper Functions
+// Alert Outcomes
 //==============================================
 
-void ContractData::updateContainers(std::shared_ptr<Candle> c, TimeFrame tf) {
-	double priceStDev = 0;
-	double volStDev = 0;
-	long volume = 0;
+void ContractData::trackOutcome(std::shared_ptr<Alerts::PerformanceResults> alert) {
+	std::unique_lock<std::mutex> lock(cdMtx);
 
-	switch (tf)
-	{
-	case TimeFrame::FiveSecs:
-		fiveSecCandles_.push_back(c);
-		sdPrice5Sec_.addValue(c->high() - c->low());
-		sdVol5Sec_.addValue(c->volume());
-
-		// Only update stdev tags after 30 minutes of data
-		if (fiveMinCandles_.size() >= 360) {
-			priceStDev = sdPrice5Sec_.numStDev(c->high() - c->low());
-			volStDev = sdVol5Sec_.numStDev(c->volume());
-			volume = c->volume();
-
-			VPT_.priceDelta5Sec = VPT_.updatePriceDelta(priceStDev);
-			VPT_.volThresh5Sec = VPT_.updateVolThreshold(volume);
-			VPT_.volStDev5Sec = VPT_.updateVolStDev(volStDev);
-		}
+	// A 5 second or higher timeframe alert is raised on the bar just pushed, which is its first bar
+	// An early tick bar alert gets its closed bar with the next update
+	const CandleSeries& fiveSec = series_[TimeFrame::FiveSecs];
+	if (!fiveSec.empty()) alert->outcome.update(fiveSec.back()->time(), fiveSec.back()->high(), fiveSec.back()->low());
+
+	bool primary = alert->settlePrimary();
+	bool settled = alert->outcome.done();
+	if (settled) alert->settle();
+	else outcomes_.push_back(alert);
+	lock.unlock();
 
-		break;
-	case TimeFrame::ThirtySecs:
-		thirtySecCandles_.push_back(c);
-		sdPrice30Sec_.addValue(c->high() - c->low());
-		sdVol30Sec_.addValue(c->volume());
+	if (primary && outcome_) outcome_(alert);
+	if (settled && outcomeGrid_) outcomeGrid_(alert);
+}
 
-		if (thirtySecCandles_.size() >= 60) {
-			priceStDev = sdPrice30Sec_.numStDev(c->high() - c->low());
-			volStDev = sdVol30Sec_.numStDev(c->volume());
-			volume = c->volume();
+bool ContractData::closeOutcome(const std::shared_ptr<Alerts::PerformanceResults>& alert) {
+	std::unique_lock<std::mutex> lock(cdMtx);
 
-			VPT_.priceDelta30Sec = VPT_.updatePriceDelta(priceStDev);
-			VPT_.volThresh30Sec = VPT_.updateVolThreshold(volume);
-			VPT_.volStDev30Sec = VPT_.updateVolStDev(volStDev);
-		}
+	auto it = std::find(outcomes_.begin(), outcomes_.end(), alert);
+	if (it == outcomes_.end()) return false;
 
-		break;
-	case TimeFrame::OneMin:
-		oneMinCandles_.push_back(c);
-		sdPrice1Min_.addValue(c->high() - c->low());
-		sdVol1Min_.addValue(c->volume());
+	*it = std::move(outcomes_.back());
+	outcomes_.pop_back();
 
-		if (oneMinCandles_.size() >= 30) {
-			priceStDev = sdPrice1Min_.numStDev(c->high() - c->low());
-			volStDev = sdVol1Min_.numStDev(c->volume());
-			volume = c->volume();
+	alert->outcome.close();
+	bool primary = alert->settlePrimary();
+	alert->settle();
+	lock.unlock();
 
-			VPT_.priceDelta1Min = VPT_.updatePriceDelta(priceStDev);
-			VPT_.volThresh1Min = VPT_.updateVolThreshold(volume);
-			VPT_.volStDev1Min = VPT_.updateVolStDev(volStDev);
-		}
+	if (primary && outcome_) outcome_(alert);
+	if (outcomeGrid_) outcomeGrid_(alert);
+	return true;
+}
+
+size_t ContractData::pendingOutcomes() {
+	std::lock_guard<std::mutex> lock(cdMtx);
+	return outcomes_.size();
+}
 
-		break;
-	case TimeFrame::FiveMin:
-		fiveMinCandles_.push_back(c);
-		sdPrice5Min_.addValue(c->high() - c->low());
-		sdVol5Min_.addValue(c->volume());
+void ContractData::updateOutcomes(const Candle& fiveSec) {
+	std::unique_lock<std::mutex> lock(cdMtx);
+	if (outcomes_.empty()) return;
 
-		if (fiveMinCandles_.size() > 6) {
-			priceStDev = sdPrice5Min_.numStDev(c->high() - c->low());
-			volStDev = sdVol5Min_.numStDev(c->volume());
-			volume = c->volume();
+	size_t kept = 0;
+	for (size_t i = 0; i < outcomes_.size(); i++) {
+		bool done = outcomes_[i]->outcome.update(fiveSec.time(), fiveSec.high(), fiveSec.low());
+		if (outcomes_[i]->settlePrimary()) primaries_.push_back(outcomes_[i]);
 
-			VPT_.priceDelta5Min = VPT_.updatePriceDelta(priceStDev);
-			VPT_.volThresh5Min = VPT_.updateVolThreshold(volume);
-			VPT_.volStDev5Min = VPT_.updateVolStDev(volStDev);
+		if (done) {
+			outcomes_[i]->settle();
+			settled_.push_back(std::move(outcomes_[i]));
 		}
+		else {
+			if (kept != i) outcomes_[kept] = std::move(outcomes_[i]);
+			kept++;
+		}
+	}
+	outcomes_.resize(kept);
+	lock.unlock();
+
+	if (outcome_) for (std::shared_ptr<Alerts::PerformanceResults>& alert : primaries_) outcome_(alert);
+	if (outcomeGrid_) for (std::shared_ptr<Alerts::PerformanceResults>& alert : settled_) outcomeGrid_(alert);
+	primaries_.clear();
+	settled_.clear();
+}
+
+//==============================================
+// Helper Functions
+//==============================================
+
+void ContractData::accumulate(const Candle& fiveSec) {
+	std::lock_guard<std::mutex> lock(cdMtx);
+	for (size_t i = 1; i < kNumTimeFrames; i++) bars_.at(i).add(fiveSec);
+}
 
-		break;
+std::shared_ptr<Candle> ContractData::sealBar(BarAccumulator& acc) {
+	std::unique_lock<std::mutex> lock(cdMtx);
+	int slot = acc.slot();
+	BarSummary bar = acc.seal();
+	lock.unlock();
+
+	std::shared_ptr<Candle> candle = makePooled<Candle>(contractId_, bar.time, bar.open, bar.high, bar.low, bar.close, bar.volume);
+	candle->setSlot(slot);
+	return candle;
+}
+
+std::shared_ptr<CandleTags> ContractData::makeTags(std::shared_ptr<Candle> c, TimeFrame tf) {
+	const TimeFrameTags& tags = VPT_.tags[tf];
+	return makePooled<CandleTags>(c, tf, optType_, tod_, tags.volStDev, tags.volThresh, tags.priceDelta, DHL_, LHL_);
+}
+
+bool ContractData::isAlertCandidate(TimeFrame tf, long time, double close, long volume) {
+	if (!alertFilter_) return true;
+
+	double volStDev = 0;
+	if (series_[tf].totalPushed() >= tfSpec(tf).warmup) volStDev = sdVol_[tf].numStDev(static_cast<double>(volume));
+
+	return alertFilter_(AlertCandidate{ contractId_, tf, time, close, volume, volStDev });
+}
+
+void ContractData::initSeries() {
+	for (const TimeFrameSpec& spec : kTimeFrames) {
+		TimeFrame tf = spec.tf;
+		series_[tf].setSpill([this, tf](const std::shared_ptr<Candle>& c) { if (spill_) spill_(tf, c); });
+	}
+}
+
+void ContractData::updateContainers(std::shared_ptr<Candle> c, TimeFrame tf) {
+	// Readers on other threads hold dataLock() while using a view
+	std::unique_lock<std::mutex> lock(cdMtx);
+	series_[tf].push(c);
+	lock.unlock();
+
+	double range = c->high() - c->low();
+	sdPrice_[tf].addValue(range);
+	sdVol_[tf].addValue(c->volume());
+
+	// Only update stdev tags once the timeframe has warmed up
+	if (series_[tf].totalPushed() >= tfSpec(tf).warmup) {
+		TimeFrameTags& tags = VPT_.tags[tf];
+		tags.priceDelta = VPT_.updatePriceDelta(sdPrice_[tf].numStDev(range));
+		tags.volThresh = VPT_.updateVolThreshold(c->volume());
+		tags.volStDev = VPT_.updateVolStDev(sdVol_[tf].numStDev(c->volume()));
+	}
+}
+
+void ContractData::adoptVerdict(std::shared_ptr<Candle> c, const FiveSecVerdict& verdict) {
+	std::unique_lock<std::mutex> lock(cdMtx);
+	series_[TimeFrame::FiveSecs].push(c);
+	lock.unlock();
+
+	sdPrice_[TimeFrame::FiveSecs].adopt(verdict.range);
+	sdVol_[TimeFrame::FiveSecs].adopt(verdict.volume);
+
+	if (verdict.warm) {
+		TimeFrameTags& tags = VPT_.tags[TimeFrame::FiveSecs];
+		tags.priceDelta = verdict.priceDelta;
+		tags.volThresh = verdict.volThresh;
+		tags.volStDev = verdict.volStDev;
 	}
 }
 
@@ -357,7 +435,7 @@ void ContractData::updateCumulativeVolume(std::shared_ptr<Candle> c) {
 
 void ContractData::updateComparisons() {
 	// Update underlying information
-	double lastPrice = fiveSecCandles_.back()->close();
+	double lastPrice = series_[TimeFrame::FiveSecs].back()->close();
 
 	// Check values against the underlying price, will use 0.1% difference
 	if (isWithinXPercent(lastPrice, dailyHigh_, percentDiff)) DHL_ = Alerts::DailyHighsAndLows::NDH;
@@ -370,16 +448,10 @@ void ContractData::updateComparisons() {
 }
 
 void ContractData::updateLocalMinMax(std::shared_ptr<Candle> c) {
-	// Every 30 minutes, update the local high and low. Temp high and low will serve to track these values in between
-	tempHigh_ = max(tempHigh_, c->high());
-	tempLow_ = min(tempLow_, c->low());
-
-	if (fiveMinCandles_.size() % 6 == 0 && fiveMinCandles_.size() > 0) {
-		localHigh_ = tempHigh_;
-		localLow_ = tempLow_;
-		tempHigh_ = 0;
-		tempLow_ = 10000;
-	}
+	localHighs_.push(c->high());
+	localLows_.push(c->low());
+	localHigh_ = localHighs_.value();
+	localLow_ = localLows_.value();
 }
 
 //===========================================================
@@ -387,51 +459,8 @@ void ContractData::updateLocalMinMax(std::shared_ptr<Candle> c) {
 //===========================================================
 
 void ContractData::updateTimeOfDay(long unixTime) {
-
-	std::time_t currentTime;
-	currentTime = static_cast<time_t>(unixTime);
-
-	// Convert the current time to local time
-	tm* localTime = std::localtime(&currentTime);
-
-	// Get the current hour and minute
-	int currentHour = localTime->tm_hour;
-	int currentMinute = localTime->tm_min;
-
-	// Calculate the time in minutes since 8:30 AM
-	int minutesSince830AM = (currentHour - 8) * 60 + currentMinute - 30;
-
-	// Calculate the slot number (1 to 7)
-	int slotNumber = minutesSince830AM / 60 + 1;
-
-	switch (slotNumber)
-	{
-	case 1:
-		tod_ = Alerts::TimeOfDay::Hour1;
-		break;
-	case 2:
-		tod_ = Alerts::TimeOfDay::Hour2;
-		break;
-	case 3:
-		tod_ = Alerts::TimeOfDay::Hour3;
-		break;
-	case 4:
-		tod_ = Alerts::TimeOfDay::Hour4;
-		break;
-	case 5:
-		tod_ = Alerts::TimeOfDay::Hour5;
-		break;
-	case 6:
-		tod_ = Alerts::TimeOfDay::Hour6;
-		break;
-	case 7:
-		tod_ = Alerts::TimeOfDay::Hour7;
-		break;
-	default:
-		OPTIONSCANNER_ERROR("Error occured calculating time of day");
-
-		break;
-	}
+	// Exchange time from the session calendar, only day changes do any calendar work
+	tod_ = calendar_.timeOfDay(unixTime);
 }
 
 void VolAndPriceTags::addReqId(int req) { reqId = req; }
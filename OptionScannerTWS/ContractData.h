@@ -3,18 +3,28 @@
 #pragma once
 
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <chrono>
 #include <ctime>
 #include <functional>
 #include <memory>
+#include <mutex>
+#include <stdexcept>
 
 #include "tWrapper.h"
 #include "Logger.h"
 #include "Enums.h"
+#include "TimeFrames.h"
 #include "Candle.h"
 #include "Formulas.h"
+#include "MemoryPool.h"
+#include "RingBuffer.h"
+#include "EpochEvaluator.h"
+#include "BarAccumulator.h"
+#include "SlidingExtrema.h"
+#include "SessionCalendar.h"
 #include "DatabaseManager.h"
 
 using std::vector;
@@ -23,27 +33,23 @@ using std::max;
 using std::min;
 using std::pair;
 
-// Helper function for combining candles
-std::shared_ptr<Candle> createNewBars(int id, int increment, const vector<std::shared_ptr<Candle>> data);
+// Each timeframe keeps a bounded ring of its newest candles, read through views that never copy
+using CandleSeries = RingBuffer<std::shared_ptr<Candle>>;
+using CandleView = RingView<std::shared_ptr<Candle>>;
 
-// Contains vol and price tags for each timeframe that will be updated with new candles
-struct VolAndPriceTags {
-
-	Alerts::VolumeStDev volStDev5Sec{ Alerts::VolumeStDev::LowVol };
-	Alerts::VolumeThreshold volThresh5Sec{ Alerts::VolumeThreshold::LowVol };
-	Alerts::PriceDelta priceDelta5Sec{ Alerts::PriceDelta::Under1 };
+// Helper function for combining candles, vectors convert to a view
+std::shared_ptr<Candle> createNewBars(int id, int increment, const CandleView& data);
 
-	Alerts::VolumeStDev volStDev30Sec{ Alerts::VolumeStDev::LowVol };
-	Alerts::VolumeThreshold volThresh30Sec{ Alerts::VolumeThreshold::LowVol };
-	Alerts::PriceDelta priceDelta30Sec{ Alerts::PriceDelta::Under1 };
-
-	Alerts::VolumeStDev volStDev1Min{ Alerts::VolumeStDev::LowVol };
-	Alerts::VolumeThreshold volThresh1Min{ Alerts::VolumeThreshold::LowVol };
-	Alerts::PriceDelta priceDelta1Min{ Alerts::PriceDelta::Under1 };
+// Vol and price tags of one timeframe, updated with each new candle of that timeframe
+struct TimeFrameTags {
+	Alerts::VolumeStDev volStDev{ Alerts::VolumeStDev::LowVol };
+	Alerts::VolumeThreshold volThresh{ Alerts::VolumeThreshold::LowVol };
+	Alerts::PriceDelta priceDelta{ Alerts::PriceDelta::Under1 };
+};
 
-	Alerts::VolumeStDev volStDev5Min{ Alerts::VolumeStDev::LowVol };
-	Alerts::VolumeThreshold volThresh5Min{ Alerts::VolumeThreshold::LowVol };
-	Alerts::PriceDelta priceDelta5Min{ Alerts::PriceDelta::Under1 };
+// Contains vol and price tags for each timeframe that will be updated with new candles
+struct VolAndPriceTags {
+	PerTimeFrame<TimeFrameTags> tags;
 
 	int reqId;
 	void addReqId(int req);
@@ -53,6 +59,28 @@ struct VolAndPriceTags {
 	Alerts::PriceDelta updatePriceDelta(double priceStDev);
 };
 
+// Read only copy of the underlying's state, published once per epoch before any option is processed
+struct UnderlyingSnapshot {
+	bool valid{ false };
+	double price{ 0 };
+	PerTimeFrame<Alerts::PriceDelta> priceDeltas{ PerTimeFrame<Alerts::PriceDelta>::build(
+		[](const TimeFrameSpec&) { return Alerts::PriceDelta::Under1; }) };
+	Alerts::DailyHighsAndLows DHL{ Alerts::DailyHighsAndLows::Inside };
+	Alerts::LocalHighsAndLows LHL{ Alerts::LocalHighsAndLows::Inside };
+
+	Alerts::PriceDelta priceDelta(TimeFrame tf) const { return priceDeltas[tf]; }
+};
+
+// Plain stats for a closed (or early 5 second) bar, checked before any tags are built
+struct AlertCandidate {
+	TickerId reqId;
+	TimeFrame tf;
+	long time;
+	double close;
+	long volume;
+	double volStDev; // Volume z-score against the timeframe's baseline, 0 until the timeframe warms up
+};
+
 //==============================================================================
 // Contract Data will perform a variety of functions for each contract under the 
 // current scope of strikes. These will inlcude:
@@ -74,7 +102,17 @@ public:
 
 	// With each incoming candle, we will need to update the vectors for each time frame
 	// This will also update stDevs for each time series
-	void updateData(std::unique_ptr<Candle> c);
+	// Candles from the wrapper are already pooled, a unique_ptr is converted on the way in
+	void updateData(std::shared_ptr<Candle> c);
+
+	// Same update with the 5 second stats, tags and alert gate already worked out for the whole chain
+	// Only for contracts on the session baseline, the evaluator owns their 5 second moments and this copies them
+	// Throws std::logic_error for any other baseline, those contracts work out their own through updateData(c)
+	void updateData(std::shared_ptr<Candle> c, const FiveSecVerdict& verdict);
+
+	// Sub 5 second bars built from ticks, these only build the partial 5 second bar so the
+	// 5 second volume alert can fire as soon as it is met. The closed 5 second bar still arrives through updateData
+	void updateTickBar(std::shared_ptr<Candle> c);
 
 	// Accessors
 	TickerId contractId() const;
@@ -82,13 +120,25 @@ public:
 	Alerts::OptionType optType() const;
 
 	// Time series accessors
-	vector<std::shared_ptr<Candle>> fiveSecData() const;
-	vector<std::shared_ptr<Candle>> thirtySecData() const;
-	vector<std::shared_ptr<Candle>> oneMinData() const;
-	vector<std::shared_ptr<Candle>> fiveMinData() const;
+	// Views are valid until the next candle, readers on other threads should hold dataLock()
+	CandleView fiveSecData() const;
+	CandleView thirtySecData() const;
+	CandleView oneMinData() const;
+	CandleView fiveMinData() const;
+	CandleView data(TimeFrame tf) const;
 
 	std::shared_ptr<Candle> latestCandle(TimeFrame tf);
-	vector<std::shared_ptr<Candle>> candlesLast30Minutes();
+	CandleView candlesLast30Minutes();
+	std::unique_lock<std::mutex> dataLock();
+
+	// Higher timeframe bar built so far from the 5 second bars, nullptr if it has none yet
+	// For 5 seconds this is the latest closed bar
+	std::shared_ptr<Candle> partialBar(TimeFrame tf);
+
+	// Candles older than the capacity are handed to the spill function before being dropped
+	// The 5 second series always keeps at least 30 minutes for alert outcomes
+	void setSeriesCapacity(TimeFrame tf, size_t capacity);
+	size_t seriesCapacity(TimeFrame tf) const;
 
 	// Other data acessors
 	double currentPrice() const;
@@ -96,6 +146,9 @@ public:
 	double dailyLow() const;
 	double localHigh() const;
 	double localLow() const;
+
+	// Trailing window in 5 second bars for the local high and low, 30 minutes by default
+	void setLocalWindow(size_t fiveSecBars);
 	long long totalVol() const;
 
 	vector<std::pair<long, long long>> volOverTime() const;
@@ -103,11 +156,28 @@ public:
 	StandardDeviation priceStDev(TimeFrame tf);
 	StandardDeviation volStDev(TimeFrame tf);
 
+	// Choose how far back the price and volume deviations of a timeframe look, the
+	// default is the whole session. The deviations are updated on the epoch workers
+	// without a lock, so like the alert callbacks this is set before the first bar
+	// Throws std::logic_error once the contract has received data
+	void setStatsBaseline(TimeFrame tf, StatsBaseline baseline);
+	const StatsBaseline& statsBaseline(TimeFrame tf) const;
+
 	// Tag Accessors
 	Alerts::PriceDelta priceDelta(TimeFrame tf);
 	Alerts::DailyHighsAndLows dailyHLComparison();
 	Alerts::LocalHighsAndLows localHLComparison();
 
+	UnderlyingSnapshot snapshot();
+
+	// Alert outcomes, each 5 second bar updates every pending alert of this contract
+	// An alert is seeded with the latest bar if that is the alert's own
+	void trackOutcome(std::shared_ptr<Alerts::PerformanceResults> alert);
+	// Settles a pending alert at the end of its window and reports whatever it hadn't yet
+	// False if it already settled on its highest target or lowest stop
+	bool closeOutcome(const std::shared_ptr<Alerts::PerformanceResults>& alert);
+	size_t pendingOutcomes();
+
 private:
 	const TickerId contractId_;
 	int strikePrice_{ 0 };
@@ -118,30 +188,35 @@ private:
 	// ****** Update this if wishing to change the percent difference between min max values and price
 	double percentDiff = 0.1;
 
-	vector<std::shared_ptr<Candle>> fiveSecCandles_;
-	vector<std::shared_ptr<Candle>> thirtySecCandles_;
-	vector<std::shared_ptr<Candle>> oneMinCandles_;
-	vector<std::shared_ptr<Candle>> fiveMinCandles_;
+	// Candles of each timeframe on the ladder, sized from kTimeFrames
+	PerTimeFrame<CandleSeries> series_{ PerTimeFrame<CandleSeries>::build(
+		[](const TimeFrameSpec& spec) { return CandleSeries(spec.capacity); }) };
 
-	// Statistic Variables
-	StandardDeviation sdPrice5Sec_;
-	StandardDeviation sdPrice30Sec_;
-	StandardDeviation sdPrice1Min_;
-	StandardDeviation sdPrice5Min_;
+	void initSeries();
+
+	// Each 5 second bar is folded into every higher timeframe, which are sealed on their boundary
+	// The base timeframe's accumulator is unused
+	PerTimeFrame<BarAccumulator> bars_;
 
-	StandardDeviation sdVol5Sec_;
-	StandardDeviation sdVol30Sec_;
-	StandardDeviation sdVol1Min_;
-	StandardDeviation sdVol5Min_;
+	void accumulate(const Candle& fiveSec);
+	std::shared_ptr<Candle> sealBar(BarAccumulator& acc);
+	std::shared_ptr<CandleTags> makeTags(std::shared_ptr<Candle> c, TimeFrame tf);
+
+	// Runs the alert filter, true if there is none
+	bool isAlertCandidate(TimeFrame tf, long time, double close, long volume);
+
+	// Statistic Variables
+	PerTimeFrame<StandardDeviation> sdPrice_;
+	PerTimeFrame<StandardDeviation> sdVol_;
 
 	double dailyHigh_;
 	double dailyLow_;
 
-	// To be used for local high and low in 30 minute frames
+	// High and low over the trailing local window
 	double localHigh_;
 	double localLow_;
-	double tempHigh_;
-	double tempLow_;
+	SlidingMax localHighs_{ 360 };
+	SlidingMin localLows_{ 360 };
 
 	// Tags that will be tracked and added to new candles
 	Alerts::OptionType optType_{ Alerts::OptionType::Call };
@@ -151,19 +226,38 @@ private:
 
 	VolAndPriceTags VPT_;
 
+	// Partial 5 second bar from tick bars, and the start of the last 5 second bar alerted early
+	long partialStart_{ -1 };
+	double partialOpen_{ 0 };
+	double partialHigh_{ 0 };
+	double partialLow_{ 0 };
+	double partialClose_{ 0 };
+	long partialVolume_{ 0 };
+	long earlyAlertTime_{ -1 };
+
+	void update(std::shared_ptr<Candle> c, const FiveSecVerdict* verdict);
+
 	// Update various trackers
 	// Update respective containers with new candles and stdev values
 	void updateContainers(std::shared_ptr<Candle> c, TimeFrame tf);
+	void adoptVerdict(std::shared_ptr<Candle> c, const FiveSecVerdict& verdict);
 	void updateCumulativeVolume(std::shared_ptr<Candle> c);
 	void updateComparisons();
 	void updateLocalMinMax(std::shared_ptr<Candle> c);
+	void updateOutcomes(const Candle& fiveSec);
 
 	// Update Tag Values
+	SessionCalendar calendar_;
 	void updateTimeOfDay(long unixTime);
 
 	// For data keeping purposes
 	vector<std::pair<long, long long>> cumulativeVolume_;
 
+	// Alerts waiting on an outcome, and those whose primary cell or whole grid settled on the current bar
+	vector<std::shared_ptr<Alerts::PerformanceResults>> outcomes_;
+	vector<std::shared_ptr<Alerts::PerformanceResults>> primaries_;
+	vector<std::shared_ptr<Alerts::PerformanceResults>> settled_;
+
 	std::mutex cdMtx;
 
 	// We will also need to keep a connection open for the underlying price
@@ -177,8 +271,31 @@ public:
 	using AlertFunction = std::function<void(std::shared_ptr<CandleTags> candle)>;
 	void registerAlert(AlertFunction alert) { alert_ = std::move(alert); }
 
+	// Cheap first stage, runs for every bar that could alert and no tags are built unless it passes
+	using AlertFilter = std::function<bool(const AlertCandidate& candidate)>;
+	void registerAlertFilter(AlertFilter filter) { alertFilter_ = std::move(filter); }
+
 private:
 	AlertFunction alert_;
+	AlertFilter alertFilter_;
+
+public:
+	using SpillFunction = std::function<void(TimeFrame tf, const std::shared_ptr<Candle>& candle)>;
+	void registerSpill(SpillFunction spill) { spill_ = std::move(spill); }
+
+private:
+	SpillFunction spill_;
+
+public:
+	// Called outside the data lock with each alert as soon as its primary cell is final
+	using OutcomeFunction = std::function<void(std::shared_ptr<Alerts::PerformanceResults> alert)>;
+	void registerOutcome(OutcomeFunction outcome) { outcome_ = std::move(outcome); }
+	// Called outside the data lock with each alert once every cell of its grid is final
+	void registerOutcomeGrid(OutcomeFunction outcomes) { outcomeGrid_ = std::move(outcomes); }
+
+private:
+	OutcomeFunction outcome_;
+	OutcomeFunction outcomeGrid_;
 };
 
 Alerts::RelativeToMoney distFromPrice(Alerts::OptionType optType, int strike, double spxPrice);
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "ContractRegistry.h"
+
+#include <stdexcept>
+#include <string>
+
+constexpr int ContractRegistry::kUnderlyingSlot;
+constexpr int ContractRegistry::kNoSlot;
+
+ContractRegistry::ContractRegistry(TickerId underlyingReq, int maxContracts, TickerId maxReqId) :
+    underlyingReq_(underlyingReq), maxContracts_(maxContracts), maxReqId_(maxReqId),
+    slotOfReq_(new std::atomic<int>[static_cast<size_t>(maxReqId)]),
+    contracts_(new std::atomic<ContractData*>[static_cast<size_t>(maxContracts)]),
+    reqIds_(static_cast<size_t>(maxContracts), 0),
+    owners_(static_cast<size_t>(maxContracts)) {
+
+    for (TickerId i = 0; i < maxReqId_; i++) slotOfReq_[i].store(kNoSlot, std::memory_order_relaxed);
+    for (int i = 0; i < maxContracts_; i++) contracts_[i].store(nullptr, std::memory_order_relaxed);
+
+    assign(underlyingReq_);
+}
+
+int ContractRegistry::assign(TickerId reqId) {
+    if (reqId < 0 || reqId >= maxReqId_) {
+        throw std::out_of_range("reqId " + std::to_string(reqId) + " is outside the contract registry");
+    }
+
+    std::lock_guard<std::mutex> lock(assignMtx_);
+    int slot = slotOfReq_[reqId].load(std::memory_order_relaxed);
+    if (slot != kNoSlot) return slot;
+
+    slot = size_.load(std::memory_order_relaxed);
+    if (slot >= maxContracts_) {
+        throw std::out_of_range("Contract registry is full, unable to assign reqId " + std::to_string(reqId));
+    }
+
+    reqIds_[slot] = reqId;
+    size_.store(slot + 1, std::memory_order_release);
+    slotOfReq_[reqId].store(slot, std::memory_order_release);
+
+    return slot;
+}
+
+int ContractRegistry::slotOf(TickerId reqId) const {
+    if (reqId < 0 || reqId >= maxReqId_) return kNoSlot;
+    return slotOfReq_[reqId].load(std::memory_order_acquire);
+}
+
+bool ContractRegistry::contains(TickerId reqId) const { return slotOf(reqId) != kNoSlot; }
+
+TickerId ContractRegistry::reqIdOf(int slot) const {
+    if (slot < 0 || slot >= size()) return -1;
+    return reqIds_[slot];
+}
+
+ContractData* ContractRegistry::attach(int slot, std::shared_ptr<ContractData> cd) {
+    if (slot < 0 || slot >= size()) throw std::out_of_range("Slot " + std::to_string(slot) + " has not been assigned");
+
+    std::lock_guard<std::mutex> lock(assignMtx_);
+    ContractData* raw = cd.get();
+    owners_[slot] = std::move(cd);
+    contracts_[slot].store(raw, std::memory_order_release);
+
+    return raw;
+}
+
+ContractData* ContractRegistry::at(int slot) const {
+    if (slot < 0 || slot >= maxContracts_) return nullptr;
+    return contracts_[slot].load(std::memory_order_acquire);
+}
+
+ContractData* ContractRegistry::underlying() const { return at(kUnderlyingSlot); }
+TickerId ContractRegistry::underlyingReq() const { return underlyingReq_; }
+
+int ContractRegistry::size() const { return size_.load(std::memory_order_acquire); }
+int ContractRegistry::capacity() const { return maxContracts_; }
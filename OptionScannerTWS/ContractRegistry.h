@@ -0,0 +1,69 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Contract registry
+// Maps each reqId to a dense slot once, when its request is sent. The
+// wrapper stamps every realtime bar with its slot, so the scanner and
+// alert handler reach a contract by indexing an array rather than
+// hashing into a map. Slot 0 always belongs to the underlying
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "TwsApiL0.h"
+
+class ContractData;
+
+class ContractRegistry {
+public:
+    static constexpr int kUnderlyingSlot = 0;
+    static constexpr int kNoSlot = -1;
+
+    // reqIds must be below maxReqId, they index a flat lookup table
+    explicit ContractRegistry(TickerId underlyingReq = 1234, int maxContracts = 512, TickerId maxReqId = 1 << 16);
+
+    // Called at subscription time, returns the existing slot if the reqId already has one
+    // Throws std::out_of_range if the reqId is outside the table or every slot is taken
+    int assign(TickerId reqId);
+
+    // Lookups are lock free and safe from any thread
+    int slotOf(TickerId reqId) const;
+    bool contains(TickerId reqId) const;
+    TickerId reqIdOf(int slot) const;
+
+    // The registry keeps attached contracts alive for the session
+    ContractData* attach(int slot, std::shared_ptr<ContractData> cd);
+    ContractData* at(int slot) const; // nullptr until attached
+    ContractData* underlying() const;
+    TickerId underlyingReq() const;
+
+    int size() const;
+    int capacity() const;
+
+    // Visits every attached contract in slot order
+    template <typename F>
+    void forEach(F f) const {
+        int n = size();
+        for (int slot = 0; slot < n; slot++) {
+            if (ContractData* cd = at(slot)) f(reqIdOf(slot), *cd);
+        }
+    }
+
+private:
+    const TickerId underlyingReq_;
+    const int maxContracts_;
+    const TickerId maxReqId_;
+
+    std::unique_ptr<std::atomic<int>[]> slotOfReq_;
+    std::unique_ptr<std::atomic<ContractData*>[]> contracts_;
+    std::vector<TickerId> reqIds_;
+    std::vector<std::shared_ptr<ContractData>> owners_;
+
+    std::atomic<int> size_{ 0 };
+    std::mutex assignMtx_; // Assignment is rare, lookups never take it
+};
@@ -461,6 +461,9 @@ namespace Alerts {
 		case Alerts::TagCategory::RelativeToMoney:
 			res = "RelativeToMoney";
 			break;
+		case Alerts::TagCategory::TimeOfDay:
+			res = "TimeOfDay";
+			break;
 		case Alerts::TagCategory::VolumeStDev:
 			res = "VolumeStDev";
 			break;
@@ -495,6 +498,7 @@ namespace Alerts {
 		if (str == "OptionType") return TagCategory::OptionType;
 		if (str == "TimeFrame") return TagCategory::TimeFrame;
 		if (str == "RelativeToMoney") return TagCategory::RelativeToMoney;
+		if (str == "TimeOfDay") return TagCategory::TimeOfDay;
 		if (str == "VolumeStDev") return TagCategory::VolumeStDev;
 		if (str == "VolumeThreshold") return TagCategory::VolumeThreshold;
 		if (str == "UnderlyingPriceDelta") return TagCategory::UnderlyingPriceDelta;
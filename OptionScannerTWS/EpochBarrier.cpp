@@ -0,0 +1,136 @@
+#include "EpochBarrier.h"
+
+#include <algorithm>
+
+#ifndef TEST_CONFIG
+#include "Logger.h"
+#endif // !TEST_CONFIG
+
+EpochBarrier::EpochBarrier(std::chrono::milliseconds deadline, int retireAfter) :
+    deadline_(deadline), retireAfter_(retireAfter) {}
+
+void EpochBarrier::expect(int reqId) {
+    subscribed_.insert(reqId);
+    expected_.insert(reqId);
+    missedEpochs_[reqId] = 0;
+}
+
+void EpochBarrier::forget(int reqId) {
+    subscribed_.erase(reqId);
+    expected_.erase(reqId);
+    missedEpochs_.erase(reqId);
+}
+
+void EpochBarrier::insert(std::shared_ptr<Candle> candle, Clock::time_point now) {
+    int req = static_cast<int>(candle->reqId());
+    long time = candle->time();
+
+    // Bars still in flight after a cancel are released without being waited on again
+    if (subscribed_.count(req)) {
+        expected_.insert(req);
+        missedEpochs_[req] = 0;
+    }
+
+    // Epoch was already sent out, hand the bar over with the next snapshot
+    if (time <= lastReleased_) {
+        lateBars_.push_back(std::move(candle));
+        lateCount_++;
+        return;
+    }
+
+    auto it = epochs_.find(time);
+    if (it == epochs_.end()) {
+        it = epochs_.emplace(time, Epoch{}).first;
+        it->second.firstArrival = now;
+    }
+
+    auto& slot = it->second.bars[req];
+
+#ifndef TEST_CONFIG
+    if (slot) OPTIONSCANNER_WARN("Duplicate bar for req {} at time {}, keeping latest", req, time);
+#endif // !TEST_CONFIG
+
+    slot = std::move(candle);
+}
+
+bool EpochBarrier::ready(Clock::time_point now) const {
+    if (epochs_.empty()) return false;
+
+    const Epoch& oldest = epochs_.begin()->second;
+    if (complete(oldest)) return true;
+    if (now - oldest.firstArrival >= deadline_) return true;
+
+    // No more bars are coming for the oldest epoch once a newer one has filled
+    for (auto it = std::next(epochs_.begin()); it != epochs_.end(); ++it) {
+        if (complete(it->second)) return true;
+    }
+
+    return false;
+}
+
+std::vector<std::shared_ptr<Candle>> EpochBarrier::release() {
+    std::vector<std::shared_ptr<Candle>> snapshot;
+    if (epochs_.empty()) return snapshot;
+
+    auto oldest = epochs_.begin();
+    Epoch& epoch = oldest->second;
+    snapshot.reserve(epoch.bars.size() + lateBars_.size());
+
+    // Late bars belong to older epochs, so each goes ahead of its contract's current bar
+    // Ensure that the underlying is inserted first
+    auto lateOptions = std::stable_partition(lateBars_.begin(), lateBars_.end(),
+        [this](const std::shared_ptr<Candle>& c) { return c->reqId() == underlyingReq_; });
+    for (auto it = lateBars_.begin(); it != lateOptions; ++it) snapshot.push_back(std::move(*it));
+
+    auto underlying = epoch.bars.find(underlyingReq_);
+    bool hasUnderlying = underlying != epoch.bars.end();
+    if (hasUnderlying) {
+        snapshot.push_back(std::move(underlying->second));
+        epoch.bars.erase(underlying);
+    }
+
+    for (auto it = lateOptions; it != lateBars_.end(); ++it) snapshot.push_back(std::move(*it));
+    lateBars_.clear();
+
+    std::vector<int> reqs;
+    reqs.reserve(epoch.bars.size());
+    for (auto& b : epoch.bars) reqs.push_back(b.first);
+    std::sort(reqs.begin(), reqs.end());
+    for (int req : reqs) snapshot.push_back(std::move(epoch.bars[req]));
+
+    // Stop waiting on reqIds that have gone quiet, they rejoin as soon as they report again
+    for (auto it = expected_.begin(); it != expected_.end();) {
+        bool reported = epoch.bars.count(*it) > 0 || (*it == underlyingReq_ && hasUnderlying);
+        if (!reported && ++missedEpochs_[*it] >= retireAfter_) {
+
+#ifndef TEST_CONFIG
+            OPTIONSCANNER_DEBUG("Req {} missed {} epochs, no longer waiting on it", *it, retireAfter_);
+#endif // !TEST_CONFIG
+            missedEpochs_.erase(*it);
+            it = expected_.erase(it);
+        }
+        else ++it;
+    }
+
+    lastReleased_ = oldest->first;
+    epochs_.erase(oldest);
+
+    return snapshot;
+}
+
+bool EpochBarrier::complete(const Epoch& epoch) const {
+    if (epoch.bars.size() < expected_.size()) return false;
+    for (int req : expected_) {
+        if (epoch.bars.find(req) == epoch.bars.end()) return false;
+    }
+    return true;
+}
+
+void EpochBarrier::setDeadline(std::chrono::milliseconds deadline) { deadline_ = deadline; }
+void EpochBarrier::setUnderlyingReq(int reqId) { underlyingReq_ = reqId; }
+
+std::chrono::milliseconds EpochBarrier::deadline() const { return deadline_; }
+size_t EpochBarrier::expectedReqs() const { return expected_.size(); }
+size_t EpochBarrier::pendingEpochs() const { return epochs_.size(); }
+size_t EpochBarrier::lateCandles() const { return lateCount_; }
+long EpochBarrier::lastReleasedTime() const { return lastReleased_; }
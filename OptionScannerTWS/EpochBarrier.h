@@ -0,0 +1,84 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Epoch barrier for realtime bars
+// Bars are grouped by their 5 second bar time. An epoch is released as a
+// chain snapshot once every expected reqId has reported for it, or once
+// the deadline since its first bar has expired, whichever comes first.
+// A reqId is expected from the moment it is subscribed, so a new
+// contract holds up the epochs it should be in until its first bar or
+// the deadline, rather than only being waited on once it has reported.
+// Later epochs are queued separately so a fast contract never overwrites
+// its own previous bar, and a slow one only delays the chain by the deadline
+//=======================================================================
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "Candle.h"
+#include "MemoryPool.h"
+
+class EpochBarrier {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    EpochBarrier(std::chrono::milliseconds deadline = std::chrono::milliseconds(500), int retireAfter = 3);
+
+    // Wait on reqId from the next epoch on, call before sending its request
+    void expect(int reqId);
+    // Stop waiting on reqId, its bars are still released if any arrive
+    void forget(int reqId);
+
+    // Add a bar received at time now
+    void insert(std::shared_ptr<Candle> candle, Clock::time_point now = Clock::now());
+
+    // True if the oldest queued epoch can be released
+    bool ready(Clock::time_point now = Clock::now()) const;
+
+    // Release the oldest epoch, underlying first followed by the remaining reqIds in order
+    // Bars that arrived after their own epoch was released are carried into this snapshot
+    std::vector<std::shared_ptr<Candle>> release();
+
+    void setDeadline(std::chrono::milliseconds deadline);
+    void setUnderlyingReq(int reqId);
+
+    std::chrono::milliseconds deadline() const;
+    size_t expectedReqs() const;
+    size_t pendingEpochs() const;
+    size_t lateCandles() const;
+    long lastReleasedTime() const;
+
+private:
+    // Map nodes come from the session pools as well since one is created per bar
+    using BarMap = std::unordered_map<int, std::shared_ptr<Candle>, std::hash<int>, std::equal_to<int>,
+        PoolAllocator<std::pair<const int, std::shared_ptr<Candle>>>>;
+
+    struct Epoch {
+        BarMap bars;
+        Clock::time_point firstArrival;
+    };
+
+    bool complete(const Epoch& epoch) const;
+
+    std::map<long, Epoch> epochs_; // Keyed on bar time, oldest first
+    std::vector<std::shared_ptr<Candle>> lateBars_;
+
+    // reqIds subscribed, those among them still being waited on, and how many released epochs each has missed
+    // A reqId that went quiet rejoins the expected set with its next bar
+    std::unordered_set<int> subscribed_;
+    std::unordered_set<int> expected_;
+    std::unordered_map<int, int> missedEpochs_;
+
+    std::chrono::milliseconds deadline_;
+    int retireAfter_; // Stop waiting on a reqId after this many consecutive missed epochs
+    int underlyingReq_{ 1234 };
+
+    long lastReleased_{ 0 };
+    size_t lateCount_{ 0 };
+};
@@ -0,0 +1,223 @@
+#include "EpochEvaluator.h"
+
+#include <cmath>
+
+namespace {
+    // Tag tables indexed by how many thresholds a value is over
+    const Alerts::VolumeStDev kVolStDevTags[] = { Alerts::VolumeStDev::LowVol, Alerts::VolumeStDev::Over1,
+        Alerts::VolumeStDev::Over2, Alerts::VolumeStDev::Over3, Alerts::VolumeStDev::Over4 };
+    const Alerts::VolumeThreshold kVolThreshTags[] = { Alerts::VolumeThreshold::LowVol, Alerts::VolumeThreshold::Vol100,
+        Alerts::VolumeThreshold::Vol250, Alerts::VolumeThreshold::Vol500, Alerts::VolumeThreshold::Vol1000 };
+    const Alerts::PriceDelta kPriceDeltaTags[] = { Alerts::PriceDelta::Under1, Alerts::PriceDelta::Under2, Alerts::PriceDelta::Over2 };
+
+    void welford(size_t count, const double* n, const double* x, double* mean, double* m2) {
+        for (size_t i = 0; i < count; i++) {
+            double delta = x[i] - mean[i];
+            mean[i] += delta / n[i];
+            m2[i] += delta * (x[i] - mean[i]);
+        }
+    }
+
+    void zScores(size_t count, const double* n, const double* x, const double* mean, const double* m2, double* z) {
+        // Deviations first, n is never 0 here so the division can run on every lane
+        for (size_t i = 0; i < count; i++) {
+            double variance = m2[i] / n[i];
+            z[i] = std::sqrt(variance > 0 ? variance : 0.0);
+        }
+
+        // Lanes with no deviation divide by 1 and are masked to 0 after
+        for (size_t i = 0; i < count; i++) {
+            double sd = z[i];
+            double live = sd > 0 ? 1.0 : 0.0;
+            z[i] = live * ((x[i] - mean[i]) / (sd + (1.0 - live)));
+        }
+    }
+}
+
+EpochEvaluator::EpochEvaluator(size_t warmup) : warmup_(warmup) {}
+
+void EpochEvaluator::setGate(const Gate& gate) { gate_ = gate; }
+const EpochEvaluator::Gate& EpochEvaluator::gate() const { return gate_; }
+
+//====================================================
+// Lanes
+//====================================================
+
+void EpochEvaluator::beginEpoch() {
+    for (int slot : slot_) seen_[slot] = 0;
+
+    slot_.clear();
+    close_.clear();
+    range_.clear();
+    volume_.clear();
+    inScope_.clear();
+    round_.clear();
+    rounds_ = 0;
+
+    verdicts_.clear();
+}
+
+size_t EpochEvaluator::addLane(int slot, double close, double range, long volume, bool inScope) {
+    ensureSlot(slot);
+
+    int round = seen_[slot]++;
+    if (round + 1 > rounds_) rounds_ = round + 1;
+
+    slot_.push_back(slot);
+    close_.push_back(close);
+    range_.push_back(range);
+    volume_.push_back(static_cast<double>(volume));
+    inScope_.push_back(inScope ? 1 : 0);
+    round_.push_back(round);
+
+    return slot_.size() - 1;
+}
+
+void EpochEvaluator::evaluate() {
+    verdicts_.assign(slot_.size(), FiveSecVerdict());
+
+    // Nearly every epoch is a single round, later rounds only hold bars carried in late
+    for (int round = 0; round < rounds_; round++) {
+        roundLanes_.clear();
+        for (size_t lane = 0; lane < round_.size(); lane++) {
+            if (round_[lane] == round) roundLanes_.push_back(lane);
+        }
+        evaluateRound(roundLanes_);
+    }
+}
+
+size_t EpochEvaluator::lanes() const { return slot_.size(); }
+const FiveSecVerdict& EpochEvaluator::verdict(size_t lane) const { return verdicts_[lane]; }
+
+//====================================================
+// Kernel
+//====================================================
+
+void EpochEvaluator::evaluateRound(const std::vector<size_t>& lanes) {
+    const size_t count = lanes.size();
+    cols_.resize(count);
+
+    // Gather each lane's inputs and its contract's moments into contiguous columns
+    for (size_t i = 0; i < count; i++) {
+        size_t lane = lanes[i];
+        int slot = slot_[lane];
+        cols_.n[i] = n_[slot];
+        cols_.volMean[i] = volMean_[slot];
+        cols_.volM2[i] = volM2_[slot];
+        cols_.rangeMean[i] = rangeMean_[slot];
+        cols_.rangeM2[i] = rangeM2_[slot];
+        cols_.volume[i] = volume_[lane];
+        cols_.range[i] = range_[lane];
+        cols_.close[i] = close_[lane];
+        cols_.inScope[i] = inScope_[lane] ? 1.0 : 0.0;
+    }
+
+    double* n = cols_.n.data();
+    const double* vol = cols_.volume.data();
+    const double* range = cols_.range.data();
+    const double* close = cols_.close.data();
+    const double* inScope = cols_.inScope.data();
+
+    // Each loop below touches only a few columns so the compiler can vectorize it
+    // without giving up on the aliasing checks between them
+    for (size_t i = 0; i < count; i++) n[i] += 1;
+
+    // Welford updates, the same arithmetic as StandardDeviation so the results match it exactly
+    welford(count, n, vol, cols_.volMean.data(), cols_.volM2.data());
+    welford(count, n, range, cols_.rangeMean.data(), cols_.rangeM2.data());
+
+    // Population deviations and z-scores, 0 while the deviation is 0
+    zScores(count, n, vol, cols_.volMean.data(), cols_.volM2.data(), cols_.volZ.data());
+    zScores(count, n, range, cols_.rangeMean.data(), cols_.rangeM2.data(), cols_.rangeZ.data());
+
+    // Classify by counting the thresholds each value is over
+    const double* volZ = cols_.volZ.data();
+    const double* rangeZ = cols_.rangeZ.data();
+    double* volTag = cols_.volTag.data();
+    double* threshTag = cols_.threshTag.data();
+    double* deltaTag = cols_.deltaTag.data();
+    double* pass = cols_.pass.data();
+
+    for (size_t i = 0; i < count; i++) {
+        double z = volZ[i];
+        volTag[i] = (z > 1 ? 1.0 : 0.0) + (z > 2 ? 1.0 : 0.0) + (z > 3 ? 1.0 : 0.0) + (z > 4 ? 1.0 : 0.0);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        double v = vol[i];
+        threshTag[i] = (v >= 100 ? 1.0 : 0.0) + (v >= 250 ? 1.0 : 0.0) + (v >= 500 ? 1.0 : 0.0) + (v >= 1000 ? 1.0 : 0.0);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        double rz = rangeZ[i];
+        deltaTag[i] = (rz >= 1 ? 1.0 : 0.0) + (rz > 2 ? 1.0 : 0.0);
+    }
+
+    // The gate sees a z-score of 0 until the contract has warmed up
+    const double warmup = static_cast<double>(warmup_);
+    const double minPrice = gate_.minPrice;
+    const double minVolume = static_cast<double>(gate_.minVolume);
+    const double minVolStDev = gate_.minVolStDev;
+    const double minAlertVolume = static_cast<double>(gate_.minAlertVolume);
+
+    for (size_t i = 0; i < count; i++) {
+        double z = volZ[i];
+        double scope = inScope[i];
+        double gateZ = n[i] >= warmup ? z : 0.0;
+        bool ok = (vol[i] > minAlertVolume) & (close[i] > minPrice) & ((vol[i] >= minVolume) | (gateZ > minVolStDev));
+        pass[i] = ok ? scope : 0.0;
+    }
+
+    // Write the moments back and expand the verdicts
+    for (size_t i = 0; i < count; i++) {
+        size_t lane = lanes[i];
+        int slot = slot_[lane];
+        n_[slot] = n[i];
+        volMean_[slot] = cols_.volMean[i];
+        volM2_[slot] = cols_.volM2[i];
+        rangeMean_[slot] = cols_.rangeMean[i];
+        rangeM2_[slot] = cols_.rangeM2[i];
+
+        FiveSecVerdict& v = verdicts_[lane];
+        v.warm = n[i] >= warmup;
+        v.candidate = pass[i] != 0;
+        v.volStDevs = v.warm ? volZ[i] : 0.0;
+        v.volStDev = kVolStDevTags[static_cast<int>(volTag[i])];
+        v.volThresh = kVolThreshTags[static_cast<int>(threshTag[i])];
+        v.priceDelta = kPriceDeltaTags[static_cast<int>(deltaTag[i])];
+        v.volume = { static_cast<int>(n[i]), cols_.volMean[i], cols_.volM2[i] };
+        v.range = { static_cast<int>(n[i]), cols_.rangeMean[i], cols_.rangeM2[i] };
+    }
+}
+
+void EpochEvaluator::ensureSlot(int slot) {
+    size_t size = static_cast<size_t>(slot) + 1;
+    if (size <= n_.size()) return;
+
+    n_.resize(size, 0);
+    volMean_.resize(size, 0);
+    volM2_.resize(size, 0);
+    rangeMean_.resize(size, 0);
+    rangeM2_.resize(size, 0);
+    seen_.resize(size, 0);
+}
+
+void EpochEvaluator::RoundColumns::resize(size_t size) {
+    if (n.size() >= size) return;
+
+    n.resize(size);
+    volume.resize(size);
+    volMean.resize(size);
+    volM2.resize(size);
+    range.resize(size);
+    rangeMean.resize(size);
+    rangeM2.resize(size);
+    close.resize(size);
+    volZ.resize(size);
+    rangeZ.resize(size);
+    inScope.resize(size);
+    pass.resize(size);
+    volTag.resize(size);
+    threshTag.resize(size);
+    deltaTag.resize(size);
+}
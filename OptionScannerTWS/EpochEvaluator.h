@@ -0,0 +1,113 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Chain wide 5 second evaluation
+// Each epoch the scanner adds one lane per option bar, and evaluate()
+// updates the session volume and range moments of every contract, takes
+// their z-scores, classifies the volume and price delta tags and runs
+// the alert gate as a few flat loops over the lanes. Moments are kept as
+// columns indexed by contract slot, gathered into lane order for the
+// pass and written back after it. Only contracts on the session
+// baseline get a lane, the evaluator owns their 5 second moments and
+// ContractData copies each lane's verdict instead of working out its
+// own tags and filter
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Enums.h"
+#include "Formulas.h"
+#include "TimeFrames.h"
+
+// One lane's result, the moments are the contract's session state after this bar
+struct FiveSecVerdict {
+    bool warm{ false };      // Warmup reached, the tags below are current
+    bool candidate{ false }; // Passed the 5 second alert gate
+    double volStDevs{ 0 };   // Volume z-score, 0 before warmup
+    Alerts::VolumeStDev volStDev{ Alerts::VolumeStDev::LowVol };
+    Alerts::VolumeThreshold volThresh{ Alerts::VolumeThreshold::LowVol };
+    Alerts::PriceDelta priceDelta{ Alerts::PriceDelta::Under1 };
+    SessionMoments volume;
+    SessionMoments range;
+};
+
+class EpochEvaluator {
+public:
+    // Same checks as the scanner's AlertGate, plus the 5 second bar's own volume floor
+    struct Gate {
+        double minPrice{ 0.05 };
+        long minVolume{ 100 };
+        double minVolStDev{ 1.0 };
+        long minAlertVolume{ 100 };
+    };
+
+    explicit EpochEvaluator(size_t warmup = tfSpec(TimeFrame::FiveSecs).warmup);
+
+    void setGate(const Gate& gate);
+    const Gate& gate() const;
+
+    // Lanes are evaluated in the order added for the same slot, so a late bar carried
+    // into the epoch is counted before the contract's current one
+    void beginEpoch();
+    size_t addLane(int slot, double close, double range, long volume, bool inScope); // slot must be assigned
+    void evaluate();
+
+    size_t lanes() const;
+    const FiveSecVerdict& verdict(size_t lane) const;
+
+private:
+    void ensureSlot(int slot);
+    void evaluateRound(const std::vector<size_t>& lanes);
+
+    size_t warmup_;
+    Gate gate_;
+
+    // Session moments by contract slot
+    std::vector<double> n_;
+    std::vector<double> volMean_;
+    std::vector<double> volM2_;
+    std::vector<double> rangeMean_;
+    std::vector<double> rangeM2_;
+
+    // Times a slot has been added this epoch, the round of its next lane
+    std::vector<int> seen_;
+
+    // Lane inputs
+    std::vector<int> slot_;
+    std::vector<double> close_;
+    std::vector<double> range_;
+    std::vector<double> volume_;
+    std::vector<unsigned char> inScope_;
+    std::vector<int> round_;
+    int rounds_{ 0 };
+
+    std::vector<FiveSecVerdict> verdicts_;
+
+    // Lanes of one round gathered into contiguous columns, reused between epochs
+    struct RoundColumns {
+        std::vector<double> n;
+        std::vector<double> volume;
+        std::vector<double> volMean;
+        std::vector<double> volM2;
+        std::vector<double> range;
+        std::vector<double> rangeMean;
+        std::vector<double> rangeM2;
+        std::vector<double> close;
+        std::vector<double> volZ;
+        std::vector<double> rangeZ;
+        // Flags and tag indexes are held as doubles so every column has the same width
+        std::vector<double> inScope;
+        std::vector<double> pass;
+        std::vector<double> volTag;
+        std::vector<double> threshTag;
+        std::vector<double> deltaTag;
+
+        void resize(size_t size);
+    };
+
+    RoundColumns cols_;
+    std::vector<size_t> roundLanes_;
+};
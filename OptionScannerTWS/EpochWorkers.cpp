@@ -0,0 +1,97 @@
+#include "EpochWorkers.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+    // Leaves core 0 to the EReader and scanner threads when there are cores to spare
+    void pinCurrentThread(unsigned index) {
+        unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+        unsigned core = (cores > 1) ? 1 + (index % (cores - 1)) : 0;
+
+#ifdef _WIN32
+        SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << core);
+#elif defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+        (void)core;
+#endif
+    }
+}
+
+EpochWorkers::EpochWorkers(unsigned workers, bool pinToCores) : pinToCores_(pinToCores) {
+    if (workers == 0) {
+        unsigned cores = std::thread::hardware_concurrency();
+        workers = (cores > 2) ? cores - 2 : 1;
+    }
+
+    threads_.reserve(workers);
+    for (unsigned i = 0; i < workers; i++) threads_.emplace_back(&EpochWorkers::workerLoop, this, i);
+}
+
+EpochWorkers::~EpochWorkers() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        stop_ = true;
+    }
+    startCv_.notify_all();
+
+    for (auto& t : threads_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+void EpochWorkers::run(const std::function<void(unsigned)>& shard) {
+    std::unique_lock<std::mutex> lock(mtx_);
+    job_ = &shard;
+    remaining_ = static_cast<unsigned>(threads_.size());
+    error_ = nullptr;
+    generation_++;
+    startCv_.notify_all();
+
+    doneCv_.wait(lock, [this] { return remaining_ == 0; });
+    job_ = nullptr;
+
+    if (error_) std::rethrow_exception(error_);
+}
+
+unsigned EpochWorkers::size() const { return static_cast<unsigned>(threads_.size()); }
+unsigned EpochWorkers::shardOf(int slot) const { return static_cast<unsigned>(slot) % size(); }
+
+void EpochWorkers::workerLoop(unsigned index) {
+    if (pinToCores_) pinCurrentThread(index);
+
+    unsigned long long seen = 0;
+    std::unique_lock<std::mutex> lock(mtx_);
+
+    while (true) {
+        startCv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) return;
+        seen = generation_;
+
+        const std::function<void(unsigned)>* job = job_;
+        lock.unlock();
+
+        std::exception_ptr err;
+        try {
+            (*job)(index);
+        }
+        catch (...) {
+            err = std::current_exception();
+        }
+
+        lock.lock();
+        if (err && !error_) error_ = err;
+        if (--remaining_ == 0) doneCv_.notify_one();
+    }
+}
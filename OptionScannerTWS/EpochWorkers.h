@@ -0,0 +1,52 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Fixed worker pool for per epoch contract processing
+// Contracts are independent once the underlying has been processed, so
+// each epoch's batch is split into one shard per worker. A contract
+// always maps to the same worker (slot % workers), keeping its data hot
+// in one core's cache, and workers are pinned to cores where supported.
+// run() is a fork join, it returns once every shard has finished
+//=======================================================================
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class EpochWorkers {
+public:
+    // 0 workers picks the hardware concurrency less the EReader and scanner threads
+    explicit EpochWorkers(unsigned workers = 0, bool pinToCores = true);
+    ~EpochWorkers();
+
+    EpochWorkers(const EpochWorkers&) = delete;
+    EpochWorkers& operator=(const EpochWorkers&) = delete;
+
+    // Calls shard(i) on worker i for every worker and blocks until all return
+    // The first exception thrown by a shard is rethrown here
+    void run(const std::function<void(unsigned)>& shard);
+
+    unsigned size() const;
+    unsigned shardOf(int slot) const;
+
+private:
+    void workerLoop(unsigned index);
+
+    std::vector<std::thread> threads_;
+    bool pinToCores_;
+
+    std::mutex mtx_;
+    std::condition_variable startCv_;
+    std::condition_variable doneCv_;
+
+    const std::function<void(unsigned)>* job_{ nullptr };
+    unsigned long long generation_{ 0 };
+    unsigned remaining_{ 0 };
+    std::exception_ptr error_;
+    bool stop_{ false };
+};
@@ -8,35 +8,156 @@
 #include <algorithm>
 #include <chrono>
 #include <ctime>
+#include <vector>
 
+// How far back a StandardDeviation looks
+// Session keeps every value since the open, Window keeps the last n values,
+// and Ewma weights each new value by alpha so older values decay away
+struct StatsBaseline {
+    enum class Kind { Session, Window, Ewma };
+
+    Kind kind{ Kind::Session };
+    size_t window{ 0 };
+    double alpha{ 0 };
+
+    static StatsBaseline session() { return {}; }
+    static StatsBaseline lastN(size_t n) { return { Kind::Window, n > 0 ? n : 1, 0 }; }
+    static StatsBaseline ewma(double alpha) { return { Kind::Ewma, 0, alpha }; }
+    // Same center of mass as an n value window
+    static StatsBaseline ewmaSpan(size_t n) { return ewma(2.0 / (static_cast<double>(n) + 1.0)); }
+};
+
+// Count, mean and sum of squared differences of a session baseline
+struct SessionMoments {
+    int n{ 0 };
+    double mean{ 0 };
+    double m2{ 0 };
+};
+
+// Running mean and standard deviation using Welford updates, which stay accurate
+// for large volumes where sum of squares cancels. The square root is only taken
+// when the deviation is read after a change
 class StandardDeviation {
 private:
+    StatsBaseline baseline_;
     int n;
 
-    double sum_{ 0 };
-    double sumSq_{ 0 };
     double mean_{ 0 };
-    double variance_{ 0 };
-    double stdDev_{ 0 };
+    double m2_{ 0 };       // Sum of squared differences from the mean, or the variance for Ewma
+
+    // Values in the window, oldest at head_ once full
+    std::vector<double> values_;
+    size_t head_{ 0 };
+    size_t replaced_{ 0 };
+
+    mutable double stdDev_{ 0 };
+    mutable bool stale_{ false };
+
+    void addSession(double x) {
+        n++;
+        double delta = x - mean_;
+        mean_ += delta / n;
+        m2_ += delta * (x - mean_);
+    }
+
+    void addWindow(double x) {
+        if (values_.size() < baseline_.window) {
+            values_.push_back(x);
+            addSession(x);
+            return;
+        }
+
+        // Swap the oldest value for the new one in O(1)
+        double old = values_[head_];
+        values_[head_] = x;
+        head_ = (head_ + 1) % values_.size();
+
+        double oldMean = mean_;
+        mean_ += (x - old) / n;
+        m2_ += (x - old) * (x - mean_ + old - oldMean);
+
+        // Rebuild from the window now and then so rounding can't build up
+        if (++replaced_ >= values_.size()) resync();
+    }
+
+    void addEwma(double x) {
+        if (n++ == 0) {
+            mean_ = x;
+            m2_ = 0;
+            return;
+        }
+
+        double delta = x - mean_;
+        mean_ += baseline_.alpha * delta;
+        m2_ = (1 - baseline_.alpha) * (m2_ + baseline_.alpha * delta * delta);
+    }
+
+    void resync() {
+        replaced_ = 0;
+        double mean = 0;
+        for (double v : values_) mean += v;
+        mean /= values_.size();
+
+        double m2 = 0;
+        for (double v : values_) m2 += (v - mean) * (v - mean);
+
+        mean_ = mean;
+        m2_ = m2;
+    }
+
+    double variance() const {
+        if (baseline_.kind == StatsBaseline::Kind::Ewma) return m2_;
+        if (n == 0) return 0;
+        return m2_ > 0 ? m2_ / n : 0;
+    }
 
 public:
-    StandardDeviation() : n(0) {}
+    StandardDeviation(StatsBaseline baseline = StatsBaseline::session()) : baseline_(baseline), n(0) {
+        if (baseline_.kind == StatsBaseline::Kind::Window) values_.reserve(baseline_.window);
+    }
 
     void addValue(double x) {
-        n++;
-        sum_ += x;
-        sumSq_ += x * x;
-        mean_ = sum_ / n;
-        variance_ = (sumSq_ - n * mean_ * mean_) / n;
-        stdDev_ = std::sqrt(variance_);
+        switch (baseline_.kind)
+        {
+        case StatsBaseline::Kind::Window:
+            addWindow(x);
+            break;
+        case StatsBaseline::Kind::Ewma:
+            addEwma(x);
+            break;
+        default:
+            addSession(x);
+            break;
+        }
+        stale_ = true;
+    }
+
+    // Session state, for adopting moments updated elsewhere (see EpochEvaluator.h)
+    SessionMoments moments() const { return { n, mean_, m2_ }; }
+    void adopt(const SessionMoments& m) {
+        n = m.n;
+        mean_ = m.mean;
+        m2_ = m.m2;
+        stale_ = true;
     }
 
     double sum() const { return n; }
-    double stDev() const { return stdDev_; }
+    int count() const { return n; }
+    const StatsBaseline& baseline() const { return baseline_; }
+
+    double stDev() const {
+        if (stale_) {
+            stdDev_ = std::sqrt(variance());
+            stale_ = false;
+        }
+        return stdDev_;
+    }
+
     double mean() const { return mean_; }
-    double numStDev(double val) {
-        if (stdDev_ == 0) return 0;
-        else return (val - mean_) / stdDev_;
+    double numStDev(double val) const {
+        double sd = stDev();
+        if (sd == 0) return 0;
+        else return (val - mean_) / sd;
     }
 };
 
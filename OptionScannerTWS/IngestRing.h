@@ -0,0 +1,136 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Bounded lock-free multi producer / single consumer ring
+// Used as the transport between the EWrapper callbacks (EReader thread)
+// and the scanner processing thread. Producers never block, if the ring
+// is full the value is dropped and counted so the consumer can report it
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template <typename T>
+class IngestRing {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit IngestRing(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+
+        mask_ = size - 1;
+        cells_ = std::unique_ptr<Cell[]>(new Cell[size]);
+        for (size_t i = 0; i < size; i++) cells_[i].sequence.store(i, std::memory_order_relaxed);
+
+        enqueuePos_.store(0, std::memory_order_relaxed);
+        dequeuePos_ = 0;
+    }
+
+    ~IngestRing() {
+        T discard;
+        while (tryPop(discard)) {}
+    }
+
+    IngestRing(const IngestRing&) = delete;
+    IngestRing& operator=(const IngestRing&) = delete;
+
+    //========================================
+    // Producer side, safe from any thread
+    //========================================
+
+    // Returns false and increments the drop counter if the ring is full
+    template <typename U>
+    bool tryPush(U&& value) {
+        Cell* cell;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            }
+            else if (diff < 0) {
+                // Consumer has not freed this slot yet, the ring is full
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (&cell->storage) T(std::forward<U>(value));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    //========================================
+    // Consumer side, single thread only
+    //========================================
+
+    bool tryPop(T& out) {
+        Cell* cell = &cells_[dequeuePos_ & mask_];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(dequeuePos_ + 1) < 0) return false;
+
+        T* value = reinterpret_cast<T*>(&cell->storage);
+        out = std::move(*value);
+        value->~T();
+
+        cell->sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        ++dequeuePos_;
+        return true;
+    }
+
+    // Drain everything currently published, returns the number of values consumed
+    template <typename F>
+    size_t consumeAll(F&& func) {
+        size_t consumed = 0;
+        T value;
+        while (tryPop(value)) {
+            func(std::move(value));
+            ++consumed;
+        }
+        return consumed;
+    }
+
+    //========================================
+    // Accessors
+    //========================================
+
+    size_t capacity() const { return mask_ + 1; }
+    size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // Called from the consumer, approximate while producers are active
+    size_t size() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        return enq > dequeuePos_ ? enq - dequeuePos_ : 0;
+    }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    size_t mask_{ 0 };
+
+    // Keep producer and consumer positions on separate cache lines
+    char pad0_[64];
+    std::atomic<size_t> enqueuePos_;
+    char pad1_[64];
+    size_t dequeuePos_;
+    char pad2_[64];
+    std::atomic<size_t> dropped_{ 0 };
+};
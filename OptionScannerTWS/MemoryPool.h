@@ -0,0 +1,155 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Slab pool for the small objects created on every bar
+// Candles, roll-up candles and CandleTags are allocated through
+// std::allocate_shared with PoolAllocator, so the object and its
+// reference count share one fixed size block carved from a slab.
+// Blocks are recycled through a free list and slabs are kept for the
+// whole session, so after warm up a bar costs no heap allocations.
+// Addresses stay stable for as long as a shared_ptr holds the block
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#include <utility>
+
+class SlabPool {
+public:
+    SlabPool(size_t blockSize, size_t blocksPerSlab = 1024) :
+        blockSize_(blockSize < sizeof(FreeBlock) ? sizeof(FreeBlock) : blockSize), blocksPerSlab_(blocksPerSlab) {}
+
+    ~SlabPool() {
+        for (void* slab : slabs_) ::operator delete(slab);
+    }
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    void* allocate() {
+        std::lock_guard<std::mutex> lock(poolMtx_);
+        if (!freeList_) addSlab();
+
+        FreeBlock* block = freeList_;
+        freeList_ = block->next;
+        inUse_++;
+        allocated_++;
+        return block;
+    }
+
+    // Blocks may be returned from any thread, ie the alert handler releasing CandleTags
+    void deallocate(void* p) {
+        std::lock_guard<std::mutex> lock(poolMtx_);
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = freeList_;
+        freeList_ = block;
+        inUse_--;
+    }
+
+    size_t blockSize() const { return blockSize_; }
+    size_t slabCount() {
+        std::lock_guard<std::mutex> lock(poolMtx_);
+        return slabs_.size();
+    }
+    size_t blocksInUse() {
+        std::lock_guard<std::mutex> lock(poolMtx_);
+        return inUse_;
+    }
+    // Every allocate() call over the pool's life, recycled or not
+    size_t blocksAllocated() {
+        std::lock_guard<std::mutex> lock(poolMtx_);
+        return allocated_;
+    }
+
+private:
+    struct FreeBlock { FreeBlock* next; };
+
+    void addSlab() {
+        char* slab = static_cast<char*>(::operator new(blockSize_ * blocksPerSlab_));
+        slabs_.push_back(slab);
+
+        // Thread the new blocks onto the free list
+        for (size_t i = blocksPerSlab_; i > 0; i--) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * blockSize_);
+            block->next = freeList_;
+            freeList_ = block;
+        }
+    }
+
+    size_t blockSize_;
+    size_t blocksPerSlab_;
+
+    std::vector<void*> slabs_;
+    FreeBlock* freeList_{ nullptr };
+    size_t inUse_{ 0 };
+    size_t allocated_{ 0 };
+
+    std::mutex poolMtx_;
+};
+
+//=======================================================================
+// Session pools are grouped in 16 byte size classes up to 512 bytes.
+// Larger or array requests fall through to the global heap
+//=======================================================================
+
+namespace MemoryPool {
+
+    constexpr size_t kSizeClassStep = 16;
+    constexpr size_t kMaxPooledSize = 512;
+
+    inline SlabPool* poolFor(size_t bytes) {
+        if (bytes == 0 || bytes > kMaxPooledSize) return nullptr;
+
+        // Function local statics so pools exist before any global that allocates through them
+        static SlabPool* pools[kMaxPooledSize / kSizeClassStep] = {};
+        static std::once_flag initFlag;
+        std::call_once(initFlag, [] {
+            for (size_t i = 0; i < kMaxPooledSize / kSizeClassStep; i++) {
+                // Intentionally never destroyed, blocks may be released during static destruction
+                pools[i] = new SlabPool((i + 1) * kSizeClassStep);
+            }
+        });
+
+        return pools[(bytes - 1) / kSizeClassStep];
+    }
+}
+
+template <typename T>
+class PoolAllocator {
+public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "PoolAllocator does not support over aligned types");
+
+        SlabPool* pool = (n == 1) ? MemoryPool::poolFor(sizeof(T)) : nullptr;
+        if (pool) return static_cast<T*>(pool->allocate());
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        SlabPool* pool = (n == 1) ? MemoryPool::poolFor(sizeof(T)) : nullptr;
+        if (pool) pool->deallocate(p);
+        else ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const noexcept { return false; }
+};
+
+// Pooled equivalent of std::make_shared
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooled(Args&&... args) {
+    return std::allocate_shared<T>(PoolAllocator<T>(), std::forward<Args>(args)...);
+}
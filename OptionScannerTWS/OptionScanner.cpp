@@ -1,7 +1,9 @@
 #include "OptionScanner.h"
 #include "Logger.h"
 
-OptionScanner::OptionScanner(const char* host, IBString ticker) : App(host), ticker(ticker) {
+constexpr size_t OptionScanner::kNoLane;
+
+OptionScanner::OptionScanner(const char* host, IBString ticker, bool tickMode) : App(host), ticker(ticker), tickMode_(tickMode) {
 
 	// Request last quote for SPX upon class initiation to get closest option strikes
 	SPX.symbol = ticker;
@@ -16,10 +18,15 @@ OptionScanner::OptionScanner(const char* host, IBString ticker) : App(host), tic
 
 	todayDate = EndDateTime(t.tm_year + 1900, t.tm_mon + 1, t.tm_mday);
 
+	// The chain wide 5 second pass applies the same gate as the alert filter
+	setAlertGate(alertGate_);
+
 	//dbm->resetCandleTables();
 
 	// Create RTB request for SPX underlying **This will not be accessible until buffer is processed
+	// The index reports no trade sizes, so the underlying streams realtime bars even in tick mode
 	// YW.showRealTimeDataOutput();
+	YW.expectBars(1234);
 	EC->reqRealTimeBars
 	(1234
 		, SPX
@@ -31,21 +38,10 @@ OptionScanner::OptionScanner(const char* host, IBString ticker) : App(host), tic
 	addedContracts.push_back(1234);
 	OPTIONSCANNER_DEBUG("Initializing scanner ... Request 1234 sent to client");
 
-	// Initialzie the contract chain
-	contractChain_ = std::make_shared<std::unordered_map<int, std::shared_ptr<ContractData>>>();
-
-	// Initialize the alert handler with a pointer to the contract map
-	alertHandler = std::make_unique<Alerts::AlertHandler>(contractChain_, dbm);
-
-	// Start the checkMessages thread
-	messageThread_ = std::thread(&OptionScanner::checkClientMessages, this);
-}
+	// Initialize the alert handler with the contract registry, the underlying already holds slot 0
+	alertHandler = std::make_unique<Alerts::AlertHandler>(YW.contracts(), dbm);
 
-void OptionScanner::checkClientMessages() {
-	while (!closeEClienthread) {
-		EC->checkMessages();
-		if (pauseMessages) std::this_thread::sleep_for(std::chrono::milliseconds(100));
-	}
+	// Incoming messages are handled by the EReader thread started in App
 }
 
 //============================================================
@@ -56,14 +52,31 @@ void OptionScanner::streamOptionData() {
 
 	// Begin by requesting a market quote, and update strikes to send out requests
 	SPX.exchange = *Exchange::IB_SMART;
-	EC->reqMktData(111, SPX, "", true);
+	std::future<MarketSnapshot> snapshot = requestSnapshot(111, SPX);
 
 	// Wait for request
-	while (YW.getReqId() != 111) continue;
+	double lastPrice = 0;
+	try {
+		if (snapshot.wait_for(std::chrono::seconds(10)) == std::future_status::ready) {
+			MarketSnapshot snap = snapshot.get();
+			lastPrice = (snap.last > 0) ? snap.last : snap.close;
+		}
+		else {
+			OPTIONSCANNER_ERROR("Timed out waiting for market data request 111");
+		}
+	}
+	catch (const RequestError& e) {
+		OPTIONSCANNER_ERROR("Market data request {} failed with code {}: {}", e.reqId(), e.errorCode(), e.what());
+	}
+
+	if (lastPrice <= 0) {
+		OPTIONSCANNER_FATAL("No price available for the underlying, unable to select option strikes");
+		return;
+	}
 	
-	OPTIONSCANNER_INFO("Market data request received, last tick price: {}", YW.lastTickPrice());
+	OPTIONSCANNER_INFO("Market data request received, last tick price: {}", lastPrice);
 
-	updateStrikes(YW.lastTickPrice());
+	updateStrikes(lastPrice);
 
 	//==========================================================================
 	// This while loop is important, as it will be open the entire day, and 
@@ -74,40 +87,25 @@ void OptionScanner::streamOptionData() {
 	while (YW.notDone()) {
 
 		// Use the wrapper conditional to check buffer
+		// realtimeBar notifies without taking the wrapper mutex, and an epoch can also be released by its deadline
+		// so wake periodically well inside the epoch deadline
 		std::unique_lock<std::mutex> lock(YW.wrapperMutex());
-		YW.wrapperConditional().wait(lock, [&] { return YW.checkBufferFull(); });
-		OPTIONSCANNER_DEBUG("Buffer full, current capacity: {}", YW.bufferCapacity());
+		bool epochReady = YW.wrapperConditional().wait_for(lock, std::chrono::milliseconds(50), [&] { return YW.checkBufferFull(); });
 
-		for (auto& candle : YW.processedFiveSecCandles()) {
+		// Sub bars are checked on every wake, well before their 5 second bar closes
+		if (tickMode_) processTickBars();
+		if (!epochReady) continue;
+		OPTIONSCANNER_DEBUG("Epoch ready, waiting on {} requests", YW.activeReqs());
 
-			int req = candle->reqId();
-
-			if (contractChain_->find(req) != contractChain_->end()) {
-				contractChain_->at(req)->updateData(std::move(candle));
-			}
-			else {
-				std::shared_ptr<ContractData> cd;
-
-				if (req == 1234) {
-					cd = std::make_shared<ContractData>(req, dbm);
-				}
-				else {
-					cd = std::make_shared<ContractData>(req);
-				}
-
-				registerAlertCallback(cd);
-				cd->updateData(std::move(candle));
-				contractChain_->insert({ req, cd });
-			}
-		}
+		processEpoch(YW.processedFiveSecCandles());
 
 		strikesUpdated_ = true;
 
 		lock.unlock();
 		optScanCV_.notify_one();
 
-		updateStrikes(contractChain_->at(1234)->currentPrice());
-		OPTIONSCANNER_DEBUG("Strikes updated, current buffer capacity: {}", YW.bufferCapacity());
+		if (underlying_.valid) updateStrikes(underlying_.price);
+		OPTIONSCANNER_DEBUG("Strikes updated, total active requests: {}", addedContracts.size());
 	}
 }
 
@@ -119,11 +117,86 @@ bool OptionScanner::strikesUpdated() { return strikesUpdated_; }
 void OptionScanner::changeStrikesUpdated() { strikesUpdated_ = false; }
 
 void OptionScanner::outputChainData() {
-	for (auto& i : *contractChain_) {
-		std::cout << "Strike: " << i.first << " Price: " << i.second->currentPrice() << std::endl;
+	YW.contracts().forEach([](TickerId req, ContractData& cd) {
+		std::cout << "Strike: " << req << " Price: " << cd.currentPrice() << std::endl;
+	});
+}
+
+void OptionScanner::processEpoch(std::vector<std::shared_ptr<Candle>> batch) {
+	ContractRegistry& contracts = YW.contracts();
+
+	shards_.resize(workers_.size());
+	for (auto& shard : shards_) shard.clear();
+	evaluator_.beginEpoch();
+
+	for (auto& candle : batch) {
+		int slot = candle->slot();
+		// Only bars for requests sent outside updateStrikes arrive without a slot
+		if (slot == ContractRegistry::kNoSlot) slot = contracts.assign(candle->reqId());
+
+		// Contracts are attached here, on the scanner thread, before any worker can see them
+		ContractData* cd = contracts.at(slot);
+		if (!cd) cd = attachContract(slot, candle->reqId());
+
+		if (slot == ContractRegistry::kUnderlyingSlot) {
+			cd->updateData(std::move(candle));
+			continue;
+		}
+
+		size_t lane = kNoLane;
+		if (cd->statsBaseline(TimeFrame::FiveSecs).kind == StatsBaseline::Kind::Session) {
+			bool inScope = contractsInScope.count(static_cast<int>(candle->reqId())) > 0;
+			lane = evaluator_.addLane(slot, candle->close(), candle->high() - candle->low(), candle->volume(), inScope);
+		}
+		shards_[workers_.shardOf(slot)].push_back({ cd, std::move(candle), lane });
+	}
+
+	// Stats, tags and the alert gate for every option bar in one pass before the workers start
+	evaluator_.evaluate();
+
+	if (ContractData* underlying = contracts.underlying()) underlying_ = underlying->snapshot();
+
+	// A contract always lands in the same shard, so it is only ever updated by one worker
+	try {
+		workers_.run([this](unsigned worker) {
+			for (auto& job : shards_[worker]) {
+				if (job.lane == kNoLane) job.cd->updateData(std::move(job.candle));
+				else job.cd->updateData(std::move(job.candle), evaluator_.verdict(job.lane));
+			}
+		});
+	}
+	catch (const std::exception& e) {
+		OPTIONSCANNER_ERROR("Error processing epoch: {}", e.what());
+	}
+}
+
+void OptionScanner::processTickBars() {
+	// Closing bars here also produces the 5 second bars of contracts that stopped trading
+	YW.flushTickBars();
+
+	for (auto& bar : YW.processedTickBars()) {
+		// Contracts are attached with their first 5 second bar, earlier sub bars are skipped
+		ContractData* cd = YW.contracts().at(bar->slot());
+		if (cd) cd->updateTickBar(std::move(bar));
 	}
 }
 
+ContractData* OptionScanner::attachContract(int slot, TickerId req) {
+	std::shared_ptr<ContractData> cd;
+
+	if (slot == ContractRegistry::kUnderlyingSlot) {
+		cd = std::make_shared<ContractData>(req, dbm);
+	}
+	else {
+		cd = std::make_shared<ContractData>(req);
+	}
+
+	ContractData* raw = YW.contracts().attach(slot, std::move(cd));
+	registerAlertCallback(raw);
+
+	return raw;
+}
+
 void OptionScanner::updateStrikes(double price) {
 	
 	std::lock_guard<std::mutex> lock(optScanMutex_);
@@ -135,7 +208,7 @@ void OptionScanner::updateStrikes(double price) {
 
 	for (auto i : strikes) {
 		// If the contracts map doesn't already contain the strike, then a new one has come into scope
-		if (contractChain_->find(i) == contractChain_->end()) {
+		if (!YW.contracts().contains(i)) {
 
 			// Create new contracts if not in map and add to queue for requests
 			Contract con;
@@ -163,11 +236,8 @@ void OptionScanner::updateStrikes(double price) {
 
 	if (!contractReqQueue.empty()) OPTIONSCANNER_INFO("{} new contracts added to request queue", contractReqQueue.size());
 
-	////////////////////// 
-	pauseMessages = true; // temporarily pause thread running checkMessages
-	/////////////////////
-	
 	// Empty queue and create the requests
+	// EClientL0 calls are safe while the EReader thread is dispatching callbacks
 	while (!contractReqQueue.empty()) {
 		Contract con = contractReqQueue.front();
 
@@ -176,13 +246,7 @@ void OptionScanner::updateStrikes(double price) {
 		else if (con.right == *ContractRight::PUT) req = static_cast<int>(con.strike + 1);
 
 		// Now create the request
-		EC->reqRealTimeBars
-		(req
-			, con
-			, 5
-			, *WhatToShow::TRADES
-			, UseRTH::OnlyRegularTradingData
-		);
+		subscribe(req, con);
 
 		OPTIONSCANNER_DEBUG("Request {} sent to client", req);
 
@@ -192,43 +256,72 @@ void OptionScanner::updateStrikes(double price) {
 		contractReqQueue.pop();
 	}
 
-	//////////////////////
-	pauseMessages = false; // resume checking messages
-	//////////////////////
-
 	OPTIONSCANNER_DEBUG("New requests sent to queue, total option active requests: {}", addedContracts.size());
+}
 
-	// If addedContracts vector exceeds current buffer size, update the buffer
-	if (static_cast<int>(addedContracts.size()) > YW.bufferCapacity()) {
-		YW.setBufferCapacity(static_cast<int>(addedContracts.size()));
-		OPTIONSCANNER_INFO("Current requests higher than buffer capacity... updating to size: {}", addedContracts.size());
+void OptionScanner::subscribe(TickerId req, const Contract& con) {
+	// Assign the slot first so the very first bar arrives stamped with it
+	// and have the barrier wait on the contract before it has ever reported
+	YW.contracts().assign(req);
+	YW.expectBars(req);
+
+	if (tickMode_) {
+		YW.tickBars().track(req);
+		// Bars are built from the RT_VOLUME trade prints, see TickBarBuilder.h
+		EC->reqMktData(req, con, *GenericTicks::RTVolume, false);
+		return;
 	}
+
+	EC->reqRealTimeBars
+	(req
+		, con
+		, 5
+		, *WhatToShow::TRADES
+		, UseRTH::OnlyRegularTradingData
+	);
 }
 
 //===================================================
 // Alert Callback Functions
 //===================================================
 
-void OptionScanner::registerAlertCallback(std::shared_ptr<ContractData> cd) {
+// The registry owns cd for the whole session, so the callback holds it by pointer
+// Callbacks run on the epoch workers and only read the underlying snapshot, so they need no lock
+void OptionScanner::registerAlertCallback(ContractData* cd) {
+	// Both stages run on the workers, contractsInScope is only rebuilt between epochs
+	cd->registerAlertFilter([this](const AlertCandidate& candidate) {
+		return alertGate_.passes(candidate, contractsInScope.count(static_cast<int>(candidate.reqId)) > 0);
+	});
+
 	cd->registerAlert([this, cd](std::shared_ptr<CandleTags> ct) {
-		std::lock_guard<std::mutex> lock(optScanMutex_);
 		// Add underlying specific tags
-		try {
-			double underlyingPrice = contractChain_->at(1234)->currentPrice();
-			Alerts::PriceDelta pd = contractChain_->at(1234)->priceDelta(ct->getTimeFrame());
-			Alerts::DailyHighsAndLows dhl = contractChain_->at(1234)->dailyHLComparison();
-			Alerts::LocalHighsAndLows lhl = contractChain_->at(1234)->localHLComparison();
-			Alerts::RelativeToMoney rtm = distFromPrice(cd->optType(), cd->strikePrice(), underlyingPrice);
-			ct->addUnderlyingTags(rtm, pd, dhl, lhl);
+		const UnderlyingSnapshot& underlying = underlying_;
+		if (underlying.valid) {
+			Alerts::RelativeToMoney rtm = distFromPrice(cd->optType(), cd->strikePrice(), underlying.price);
+			ct->addUnderlyingTags(rtm, underlying.priceDelta(ct->getTimeFrame()), underlying.DHL, underlying.LHL);
 		}
-		catch (const std::exception& e) {
-			OPTIONSCANNER_ERROR("Issue with callback: {}" ,e.what());
+		else {
+			OPTIONSCANNER_ERROR("Issue with callback: no data received for the underlying yet");
 		}
-		// Send to dbm queue if price is significant
-		if (cd->currentPrice() > 0.05) dbm->addToInsertionQueue(ct);
+		// The gate already checked the price is significant
+		dbm->addToInsertionQueue(ct);
 		// Send to Alerthandler queue
 		alertHandler->inputAlert(ct);
 	});
+
+	// Outcomes settled by the contract's own bars, the primary result first and the whole grid once it is final
+	cd->registerOutcome([this](std::shared_ptr<Alerts::PerformanceResults> a) { alertHandler->recordOutcome(a); });
+	cd->registerOutcomeGrid([this](std::shared_ptr<Alerts::PerformanceResults> a) { alertHandler->recordOutcomeGrid(a); });
+}
+
+void OptionScanner::setAlertGate(const AlertGate& gate) {
+	alertGate_ = gate;
+
+	EpochEvaluator::Gate epochGate = evaluator_.gate();
+	epochGate.minPrice = gate.minPrice;
+	epochGate.minVolume = gate.minVolume;
+	epochGate.minVolStDev = gate.minVolStDev;
+	evaluator_.setGate(epochGate);
 }
 
 
@@ -239,8 +332,12 @@ void OptionScanner::registerAlertCallback(std::shared_ptr<ContractData> cd) {
 void OptionScanner::prepareContractData() {
 	std::cout << "Market closed, ending realTimeBar connection" << std::endl;
 	
-	for (auto& i : *contractChain_) EC->cancelRealTimeBars(i.first);
-	EC->cancelRealTimeBars(1234);
+	// The underlying sits in slot 0, so it is cancelled along with the options
+	YW.contracts().forEach([this](TickerId req, ContractData&) {
+		if (YW.tickBars().isTracked(req)) EC->cancelMktData(req);
+		else EC->cancelRealTimeBars(req);
+		YW.forgetBars(req);
+	});
 }
 
 //=====================================================
@@ -13,6 +13,7 @@
 #include "App.h"
 #include "ContractData.h"
 #include "AlertHandler.h"
+#include "EpochWorkers.h"
 #include "DatabaseManager.h"
 
 #include <unordered_map>
@@ -22,14 +23,24 @@
 #include <thread>
 #include <algorithm>
 
+// First stage of the alert pipeline, a bar only gets tags and reaches the db and alert handler if
+// its contract is in scope, its price is significant, and its volume is either large or unusual
+struct AlertGate {
+	double minPrice{ 0.05 };
+	long minVolume{ 100 };
+	double minVolStDev{ 1.0 };
+
+	bool passes(const AlertCandidate& candidate, bool inScope) const {
+		if (!inScope || candidate.close <= minPrice) return false;
+		return candidate.volume >= minVolume || candidate.volStDev > minVolStDev;
+	}
+};
 
 class OptionScanner : public App {
 public:
 	// Option scanner will share the same constructor and destructor as App
-	OptionScanner(const char* host, IBString ticker);
-
-	// Run EC->checkMessages on its own thread
-	void checkClientMessages();
+	// In tick mode options are streamed with reqMktData and built into bars in process, see TickBarBuilder.h
+	OptionScanner(const char* host, IBString ticker, bool tickMode = false);
 
 	// Called each market open
 	// void prepForOpen();
@@ -38,7 +49,8 @@ public:
 	void streamOptionData();
 
 	// Alert Callback Functions
-	void registerAlertCallback(std::shared_ptr<ContractData> cd);
+	void registerAlertCallback(ContractData* cd);
+	void setAlertGate(const AlertGate& gate); // Set before streaming starts
 
 	// Functions for storing data after market close
 	void prepareContractData();
@@ -56,10 +68,6 @@ private:
 
 	IBString todayDate; // Updated each day
 
-	std::thread messageThread_; // Used to continuously check messages
-	bool closeEClienthread{ false };
-	bool pauseMessages{ false };
-	
 	// We will update the strikes periodically to ensure that they are close to the underlying
 	void updateStrikes(double price);
 	bool strikesUpdated_{ false };
@@ -68,11 +76,34 @@ private:
 	// This will output the options chain to the screen for debugging purposes
 	// void outputChain();
 
-	// This map will hold all of the contracts and will be updated repeatedly
-	std::shared_ptr<std::unordered_map<int, std::shared_ptr<ContractData>>> contractChain_;
+	// Contracts live in the wrapper's ContractRegistry, indexed by the slot stamped on each candle
+	ContractData* attachContract(int slot, TickerId req);
+
+	// Assigns the contract slot and sends the streaming request for the current mode
+	void subscribe(TickerId req, const Contract& con);
+	void processTickBars();
+	bool tickMode_;
+
+	// Options are updated in parallel, one shard per worker, after the underlying has been processed
+	void processEpoch(std::vector<std::shared_ptr<Candle>> batch);
+
+	// Lane holds the option's 5 second verdict from the chain wide pass, see EpochEvaluator.h
+	// Contracts off the session baseline aren't given a lane and work out their own stats
+	static constexpr size_t kNoLane = static_cast<size_t>(-1);
+	struct EpochJob {
+		ContractData* cd;
+		std::shared_ptr<Candle> candle;
+		size_t lane;
+	};
+
+	EpochWorkers workers_;
+	EpochEvaluator evaluator_;
+	std::vector<std::vector<EpochJob>> shards_;
+	UnderlyingSnapshot underlying_; // Only written between epochs, read by alert callbacks on the workers
 
 	std::queue<Contract> contractReqQueue; // Holds new contracts to request data
 	std::unordered_set<int> contractsInScope; // If a contract isn't in the main scope of 18, it won't create an alert
+	AlertGate alertGate_;
 	vector<int> addedContracts; // Keep track of all currently requested contracts
 
 	std::unique_ptr<Alerts::AlertHandler> alertHandler;
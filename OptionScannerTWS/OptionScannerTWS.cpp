@@ -157,24 +157,26 @@ void basicHistoricalDataRequest(std::unique_ptr<App>& test) {
     C.includeExpired = true;
     C.strike = 4450;
 
-    test->EC->reqHistoricalData
+    // Callbacks arrive on the EReader thread started by App, so just wait on the future
+    std::future<std::vector<std::unique_ptr<Candle>>> candles = test->requestHistoricalData
     (10
         , C
         , "20230915 13:00:00 US/Central"
         , "3600 S"
         , "1 min"
-        , *WhatToShow::TRADES
-        , UseRTH::OnlyRegularTradingData
-        , FormatDate::AsDate
-        , false
     );
 
-    while (test->YW.notDone()) {
-        test->EC->checkMessages();
-        if (test->YW.getReqId() == 10) break;
+    try {
+        if (candles.wait_for(std::chrono::seconds(30)) == std::future_status::ready) {
+            cout << "Num test candles received: " << candles.get().size() << endl;
+        }
+        else {
+            cout << "Timed out waiting for historical data request 10" << endl;
+        }
+    }
+    catch (const RequestError& e) {
+        cout << "Historical data request failed with code " << e.errorCode() << ": " << e.what() << endl;
     }
-    
-    cout << "Num test candles received: " << test->YW.historicCandles().size() << endl;
 }
 
 //=================================================================
@@ -194,13 +196,19 @@ void testMktDataRequest(std::unique_ptr<App>& test) {
     C.exchange = "SMART";
     C.primaryExchange = *Exchange::CBOE;
 
-    test->EC->reqMktData(11, C, *GenericTicks::MiscellaneousStats, true);
+    std::future<MarketSnapshot> snapshot = test->requestSnapshot(11, C, *GenericTicks::MiscellaneousStats);
 
-    while (test->YW.getReqId() != 11) {
-        test->EC->checkMessages();
+    try {
+        if (snapshot.wait_for(std::chrono::seconds(10)) == std::future_status::ready) {
+            cout << snapshot.get().last << endl;
+        }
+        else {
+            cout << "Timed out waiting for market data request 11" << endl;
+        }
+    }
+    catch (const RequestError& e) {
+        cout << "Market data request failed with code " << e.errorCode() << ": " << e.what() << endl;
     }
-
-    cout << test->YW.lastTickPrice() << endl;
 }
 
 ////=================================================================
@@ -230,16 +238,17 @@ void testRealTimeBars(std::unique_ptr<App>& test) {
         , UseRTH::OnlyRegularTradingData
     );
 
-    // Let run for 15 secs
+    // Let run for 15 secs, bars are printed from the EReader thread as they arrive
     int timer = 15;
 
     while (test->YW.notDone()) {
         if (timer <= 0) break;
-        test->EC->checkMessages();
 
         std::this_thread::sleep_for(std::chrono::seconds(1));
         timer -= 1;
     }
+
+    test->EC->cancelRealTimeBars(20);
 }
 
 void runAlertDBTests() {
@@ -0,0 +1,54 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Compact realtime bar
+// The 5 second bar as it travels from the wrapper callbacks to the
+// scanner thread. Prices are whole cents, which holds both the index and
+// option increments exactly, and time and volume are 32 bits, so a bar
+// is 32 trivially copyable bytes against the ~100 of a Candle. Bars
+// become full Candles only once they reach the epoch barrier
+//=======================================================================
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+constexpr int kPriceTicksPerUnit = 100;
+
+struct RealtimeBar {
+    int32_t reqId;
+    int32_t slot;   // Dense contract slot, -1 if the reqId was never registered
+    uint32_t time;
+    int32_t open;   // Prices in ticks of 1 / kPriceTicksPerUnit
+    int32_t high;
+    int32_t low;
+    int32_t close;
+    int32_t volume;
+
+    static RealtimeBar make(long reqId, long time, double open, double high, double low, double close, long volume, int slot = -1) {
+        RealtimeBar bar;
+        bar.reqId = static_cast<int32_t>(reqId);
+        bar.slot = slot;
+        bar.time = static_cast<uint32_t>(time);
+        bar.open = toTicks(open);
+        bar.high = toTicks(high);
+        bar.low = toTicks(low);
+        bar.close = toTicks(close);
+        bar.volume = volume > std::numeric_limits<int32_t>::max() ? std::numeric_limits<int32_t>::max() : static_cast<int32_t>(volume);
+        return bar;
+    }
+
+    static int32_t toTicks(double price) { return static_cast<int32_t>(std::llround(price * kPriceTicksPerUnit)); }
+    static double toPrice(int32_t ticks) { return static_cast<double>(ticks) / kPriceTicksPerUnit; }
+
+    double openPrice() const { return toPrice(open); }
+    double highPrice() const { return toPrice(high); }
+    double lowPrice() const { return toPrice(low); }
+    double closePrice() const { return toPrice(close); }
+};
+
+static_assert(sizeof(RealtimeBar) == 32, "RealtimeBar should stay at 32 bytes");
+static_assert(std::is_trivially_copyable<RealtimeBar>::value, "RealtimeBar must stay trivially copyable");
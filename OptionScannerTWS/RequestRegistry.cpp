@@ -0,0 +1,146 @@
+#include "RequestRegistry.h"
+
+//====================================================
+// Registration
+//====================================================
+
+namespace {
+    // A reqId reused before its response arrived fails the earlier request rather than mixing the two
+    template <typename Map>
+    void supersede(Map& requests, TickerId reqId) {
+        auto it = requests.find(reqId);
+        if (it == requests.end()) return;
+
+        it->second.promise.set_exception(std::make_exception_ptr(
+            RequestError(reqId, -1, "Request superseded by a new request with the same id")));
+        requests.erase(it);
+    }
+}
+
+std::future<MarketSnapshot> RequestRegistry::expectSnapshot(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    supersede(snapshots_, reqId);
+    return snapshots_[reqId].promise.get_future();
+}
+
+std::future<std::vector<std::unique_ptr<Candle>>> RequestRegistry::expectHistoricalData(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    supersede(historical_, reqId);
+    return historical_[reqId].promise.get_future();
+}
+
+std::future<std::vector<ContractDetails>> RequestRegistry::expectContractDetails(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    supersede(details_, reqId);
+    return details_[reqId].promise.get_future();
+}
+
+//====================================================
+// Wrapper callbacks
+//====================================================
+
+bool RequestRegistry::snapshotTick(TickerId reqId, TickType field, double price) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    auto it = snapshots_.find(reqId);
+    if (it == snapshots_.end()) return false;
+
+    MarketSnapshot& snap = it->second.value;
+    switch (field)
+    {
+    case TickType::LAST: snap.last = price; break;
+    case TickType::BID: snap.bid = price; break;
+    case TickType::ASK: snap.ask = price; break;
+    case TickType::HIGH: snap.high = price; break;
+    case TickType::LOW: snap.low = price; break;
+    case TickType::CLOSE: snap.close = price; break;
+    case TickType::OPEN: snap.open = price; break;
+    default: break;
+    }
+
+    return true;
+}
+
+bool RequestRegistry::snapshotEnd(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    return complete(snapshots_, reqId);
+}
+
+bool RequestRegistry::historicalBar(TickerId reqId, std::unique_ptr<Candle>& candle) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    auto it = historical_.find(reqId);
+    if (it == historical_.end()) return false;
+
+    it->second.value.push_back(std::move(candle));
+    return true;
+}
+
+bool RequestRegistry::historicalEnd(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    return complete(historical_, reqId);
+}
+
+bool RequestRegistry::contractDetails(TickerId reqId, const ContractDetails& details) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    auto it = details_.find(reqId);
+    if (it == details_.end()) return false;
+
+    it->second.value.push_back(details);
+    return true;
+}
+
+bool RequestRegistry::contractDetailsEnd(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    return complete(details_, reqId);
+}
+
+bool RequestRegistry::fail(TickerId reqId, int errorCode, const std::string& message) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    RequestError err(reqId, errorCode, message);
+
+    bool failed = failIn(snapshots_, reqId, err);
+    failed |= failIn(historical_, reqId, err);
+    failed |= failIn(details_, reqId, err);
+
+    return failed;
+}
+
+bool RequestRegistry::isPending(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    return snapshots_.count(reqId) > 0 || historical_.count(reqId) > 0 || details_.count(reqId) > 0;
+}
+
+size_t RequestRegistry::pendingCount() {
+    std::lock_guard<std::mutex> lock(registryMtx_);
+    return snapshots_.size() + historical_.size() + details_.size();
+}
+
+//====================================================
+// Helpers
+//====================================================
+
+template <typename T>
+bool RequestRegistry::complete(std::unordered_map<TickerId, Pending<T>>& requests, TickerId reqId) {
+    auto it = requests.find(reqId);
+    if (it == requests.end()) return false;
+
+    it->second.promise.set_value(std::move(it->second.value));
+    requests.erase(it);
+    return true;
+}
+
+template <typename T>
+bool RequestRegistry::failIn(std::unordered_map<TickerId, Pending<T>>& requests, TickerId reqId, const RequestError& err) {
+    auto it = requests.find(reqId);
+    if (it == requests.end()) return false;
+
+    it->second.promise.set_exception(std::make_exception_ptr(err));
+    requests.erase(it);
+    return true;
+}
+
+bool isRequestFailure(int errorCode) {
+    // 2100 - 2199 are connection and data farm notices, 10167 is the delayed market data notice
+    if (errorCode >= 2100 && errorCode < 2200) return false;
+    if (errorCode == 10167) return false;
+    return true;
+}
@@ -0,0 +1,92 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Request registry
+// Correlates one shot TWS requests with their responses by reqId.
+// Registering a request returns a std::future that is fulfilled when the
+// matching end callback arrives, or fails with a RequestError if TWS
+// reports an error for that reqId. Independent requests can be sent
+// together and waited on together instead of polling a shared reqId
+//=======================================================================
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Candle.h"
+#include "TwsApiL0.h"
+
+// Fields received for a market data snapshot, 0 if TWS did not send the tick
+struct MarketSnapshot {
+    double last{ 0 };
+    double bid{ 0 };
+    double ask{ 0 };
+    double high{ 0 };
+    double low{ 0 };
+    double close{ 0 };
+    double open{ 0 };
+};
+
+class RequestError : public std::runtime_error {
+public:
+    RequestError(TickerId reqId, int errorCode, const std::string& message) :
+        std::runtime_error(message), reqId_(reqId), errorCode_(errorCode) {}
+
+    TickerId reqId() const { return reqId_; }
+    int errorCode() const { return errorCode_; }
+
+private:
+    TickerId reqId_;
+    int errorCode_;
+};
+
+class RequestRegistry {
+public:
+    // Register before sending the request so no callback can be missed
+    std::future<MarketSnapshot> expectSnapshot(TickerId reqId);
+    std::future<std::vector<std::unique_ptr<Candle>>> expectHistoricalData(TickerId reqId);
+    std::future<std::vector<ContractDetails>> expectContractDetails(TickerId reqId);
+
+    // Wrapper side, each returns false if no request is registered for reqId
+    bool snapshotTick(TickerId reqId, TickType field, double price);
+    bool snapshotEnd(TickerId reqId);
+    // candle is only moved from when a request is registered, otherwise the caller keeps it
+    bool historicalBar(TickerId reqId, std::unique_ptr<Candle>& candle);
+    bool historicalEnd(TickerId reqId);
+    bool contractDetails(TickerId reqId, const ContractDetails& details);
+    bool contractDetailsEnd(TickerId reqId);
+
+    // Fails whichever request is registered for reqId
+    bool fail(TickerId reqId, int errorCode, const std::string& message);
+
+    bool isPending(TickerId reqId);
+    size_t pendingCount();
+
+private:
+    template <typename T>
+    struct Pending {
+        std::promise<T> promise;
+        T value;
+    };
+
+    template <typename T>
+    static bool complete(std::unordered_map<TickerId, Pending<T>>& requests, TickerId reqId);
+
+    template <typename T>
+    static bool failIn(std::unordered_map<TickerId, Pending<T>>& requests, TickerId reqId, const RequestError& err);
+
+    std::unordered_map<TickerId, Pending<MarketSnapshot>> snapshots_;
+    std::unordered_map<TickerId, Pending<std::vector<std::unique_ptr<Candle>>>> historical_;
+    std::unordered_map<TickerId, Pending<std::vector<ContractDetails>>> details_;
+
+    std::mutex registryMtx_;
+};
+
+// TWS uses error callbacks for informational messages as well, these should not fail a request
+bool isRequestFailure(int errorCode);
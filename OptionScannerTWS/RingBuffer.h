@@ -0,0 +1,160 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Fixed capacity time series
+// RingBuffer keeps the newest values of a series in one contiguous
+// allocation. Once full, each push hands the oldest value to the spill
+// callback (if any) before overwriting it, so memory stays flat for the
+// whole session. RingView is a read only span over a window of the
+// ring, at most two contiguous runs, and never allocates. A view is
+// valid until the next push to its ring
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class RingView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        const_iterator(const RingView* view, size_t i) : view_(view), i_(i) {}
+
+        reference operator*() const { return (*view_)[i_]; }
+        pointer operator->() const { return &(*view_)[i_]; }
+        const_iterator& operator++() { i_++; return *this; }
+        const_iterator operator++(int) { const_iterator tmp = *this; i_++; return tmp; }
+        const_iterator& operator--() { i_--; return *this; }
+        const_iterator& operator+=(difference_type n) { i_ += n; return *this; }
+        const_iterator operator+(difference_type n) const { return const_iterator(view_, i_ + n); }
+        difference_type operator-(const const_iterator& o) const { return static_cast<difference_type>(i_) - static_cast<difference_type>(o.i_); }
+        reference operator[](difference_type n) const { return (*view_)[i_ + n]; }
+
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+        bool operator<(const const_iterator& o) const { return i_ < o.i_; }
+
+    private:
+        const RingView* view_;
+        size_t i_;
+    };
+
+    RingView() = default;
+    RingView(const T* first, size_t firstLen, const T* second = nullptr, size_t secondLen = 0) :
+        first_(first), firstLen_(firstLen), second_(second), secondLen_(secondLen) {}
+
+    // A vector is a single contiguous run
+    RingView(const std::vector<T>& v) : first_(v.data()), firstLen_(v.size()) {}
+
+    size_t size() const { return firstLen_ + secondLen_; }
+    bool empty() const { return size() == 0; }
+
+    const T& operator[](size_t i) const { return (i < firstLen_) ? first_[i] : second_[i - firstLen_]; }
+    const T& front() const { return (*this)[0]; }
+    const T& back() const { return (*this)[size() - 1]; }
+
+    // Newest n values, or all of them if fewer
+    RingView last(size_t n) const {
+        if (n >= size()) return *this;
+        size_t skip = size() - n;
+        if (skip >= firstLen_) return RingView(second_ + (skip - firstLen_), n);
+        return RingView(first_ + skip, firstLen_ - skip, second_, secondLen_);
+    }
+
+    // The two contiguous runs, oldest first, for kernels that want raw pointers
+    std::pair<const T*, size_t> firstRun() const { return { first_, firstLen_ }; }
+    std::pair<const T*, size_t> secondRun() const { return { second_, secondLen_ }; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+    // Copies only when a caller really needs ownership
+    std::vector<T> toVector() const { return std::vector<T>(begin(), end()); }
+
+private:
+    const T* first_{ nullptr };
+    size_t firstLen_{ 0 };
+    const T* second_{ nullptr };
+    size_t secondLen_{ 0 };
+};
+
+template <typename T>
+class RingBuffer {
+public:
+    using SpillFunction = std::function<void(const T&)>;
+
+    explicit RingBuffer(size_t capacity) : data_(capacity > 0 ? capacity : 1) {}
+
+    void setSpill(SpillFunction spill) { spill_ = std::move(spill); }
+
+    void push(T value) {
+        if (size_ == data_.size()) {
+            if (spill_) spill_(data_[head_]);
+            data_[head_] = std::move(value);
+            head_ = (head_ + 1) % data_.size();
+        }
+        else {
+            data_[(head_ + size_) % data_.size()] = std::move(value);
+            size_++;
+        }
+        pushed_++;
+    }
+
+    // Keeps the newest values that fit, spilling the rest
+    void setCapacity(size_t capacity) {
+        if (capacity == 0) capacity = 1;
+        std::vector<T> resized(capacity);
+
+        size_t keep = (size_ < capacity) ? size_ : capacity;
+        size_t drop = size_ - keep;
+        for (size_t i = 0; i < drop; i++) {
+            if (spill_) spill_(at(i));
+        }
+        for (size_t i = 0; i < keep; i++) resized[i] = std::move(data_[(head_ + drop + i) % data_.size()]);
+
+        data_ = std::move(resized);
+        head_ = 0;
+        size_ = keep;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return data_.size(); }
+    bool empty() const { return size_ == 0; }
+
+    // Every value ever pushed, including the ones spilled
+    size_t totalPushed() const { return pushed_; }
+
+    // 0 is the oldest value still held
+    const T& at(size_t i) const { return data_[(head_ + i) % data_.size()]; }
+    const T& operator[](size_t i) const { return at(i); }
+    const T& back() const {
+        if (size_ == 0) throw std::out_of_range("RingBuffer is empty");
+        return at(size_ - 1);
+    }
+
+    RingView<T> view() const {
+        size_t firstLen = (head_ + size_ <= data_.size()) ? size_ : data_.size() - head_;
+        return RingView<T>(data_.data() + head_, firstLen, data_.data(), size_ - firstLen);
+    }
+
+    RingView<T> last(size_t n) const { return view().last(n); }
+
+private:
+    std::vector<T> data_;
+    size_t head_{ 0 };
+    size_t size_{ 0 };
+    size_t pushed_{ 0 };
+    SpillFunction spill_;
+};
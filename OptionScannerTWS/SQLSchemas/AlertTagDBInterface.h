@@ -27,34 +27,14 @@ namespace OptionDB {
 
 			std::unordered_map<std::pair<string, string>, int, PairHash> tagInterface() { return tagDBInterface; }
 
+			// Table ids in TagCategory order, each is an offset from the packed tag
 			std::vector<int> convertAlert(Alerts::AlertTags tags) {
 				std::vector<int> tagID;
+				Alerts::TagWord word = tags.word();
 
-				std::pair<string, string> p1{ Alerts::EnumString::option_type(tags.optType), "OptionType" };
-				std::pair<string, string> p2{ time_frame(tags.timeFrame), "TimeFrame" };
-				std::pair<string, string> p3{ Alerts::EnumString::relative_to_money(tags.rtm), "RelativeToMoney" };
-				std::pair<string, string> p4{ Alerts::EnumString::time_of_day(tags.timeOfDay), "TimeOfDay" };
-				std::pair<string, string> p5{ Alerts::EnumString::vol_st_dev(tags.volStDev), "VolumeStDev" };
-				std::pair<string, string> p6{ Alerts::EnumString::vol_threshold(tags.volThreshold), "VolumeThreshold" };
-				std::pair<string, string> p7{ Alerts::EnumString::price_delta(tags.underlyingPriceDelta), "UnderlyingPriceDelta" };
-				std::pair<string, string> p8{ Alerts::EnumString::price_delta(tags.optionPriceDelta), "OptionPriceDelta" };
-				std::pair<string, string> p9{ Alerts::EnumString::daily_highs_and_lows(tags.underlyingDailyHL), "UnderlyingDailyHighsAndLows" };
-				std::pair<string, string> p10{ Alerts::EnumString::daily_highs_and_lows(tags.optionDailyHL), "OptionDailyHighsAndLows" };
-				std::pair<string, string> p11{ Alerts::EnumString::local_highs_and_lows(tags.underlyingLocalHL), "UnderlyingLocalHighsAndLows" };
-				std::pair<string, string> p12{ Alerts::EnumString::local_highs_and_lows(tags.optionLocalHL), "OptionLocalHighsAndLows" };
-
-				tagID.push_back(tagDBInterface[p1]);
-				tagID.push_back(tagDBInterface[p2]);
-				tagID.push_back(tagDBInterface[p3]);
-				tagID.push_back(tagDBInterface[p4]);
-				tagID.push_back(tagDBInterface[p5]);
-				tagID.push_back(tagDBInterface[p6]);
-				tagID.push_back(tagDBInterface[p7]);
-				tagID.push_back(tagDBInterface[p8]);
-				tagID.push_back(tagDBInterface[p9]);
-				tagID.push_back(tagDBInterface[p10]);
-				tagID.push_back(tagDBInterface[p11]);
-				tagID.push_back(tagDBInterface[p12]);
+				for (size_t i = 0; i < Alerts::kNumTagCategories; i++) {
+					tagID.push_back(word.dbId(static_cast<Alerts::TagCategory>(i)));
+				}
 
 				return tagID;
 			}
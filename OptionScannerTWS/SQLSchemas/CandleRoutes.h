@@ -7,12 +7,14 @@
 #include "../Enums.h"
 #include "../Logger.h"
 #include "PerformanceResults.h"
+#include "TagCube.h"
 
 using std::string;
 
 namespace OptionDB {
 
 	inline void resetCandleTables(nanodbc::connection conn) {
+		nanodbc::execute(conn, "DROP TABLE IF EXISTS CandleOutcomes");
 		nanodbc::execute(conn, "DROP TABLE IF EXISTS CandlePerformance");
 		nanodbc::execute(conn, "DROP TABLE IF EXISTS OptionCandles");
 		nanodbc::execute(conn, "DROP TABLE IF EXISTS UnderlyingCandles");
@@ -302,18 +304,20 @@ namespace OptionDB {
 					high.push_back(candle[i]->candle.high());
 					low.push_back(candle[i]->candle.low());
 					volume.push_back(candle[i]->candle.volume());
-					timeFrame.push_back(Alerts::TagDBInterface::tagToInt[{time_frame(candle[i]->getTimeFrame()), Alerts::EnumString::tag_category(Alerts::TagCategory::TimeFrame)}]);
-					optionType.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::option_type(candle[i]->getOptType()), Alerts::EnumString::tag_category(Alerts::TagCategory::OptionType)}]);
-					timeOfDay.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::time_of_day(candle[i]->getTOD()), Alerts::EnumString::tag_category(Alerts::TagCategory::TimeOfDay)}]);
-					relativeToMoney.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::relative_to_money(candle[i]->getRTM()), Alerts::EnumString::tag_category(Alerts::TagCategory::RelativeToMoney)}]);
-					volumeStDev.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::vol_st_dev(candle[i]->getVolStDev()), Alerts::EnumString::tag_category(Alerts::TagCategory::VolumeStDev)}]);
-					volumeThreshold.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::vol_threshold(candle[i]->getVolThresh()), Alerts::EnumString::tag_category(Alerts::TagCategory::VolumeThreshold)}]);
-					optPriceDelta.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::price_delta(candle[i]->getOptPriceDelta()), Alerts::EnumString::tag_category(Alerts::TagCategory::OptionPriceDelta)}]);
-					dailyHighLow.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::daily_highs_and_lows(candle[i]->getDHL()), Alerts::EnumString::tag_category(Alerts::TagCategory::OptionDailyHighsAndLows)}]);
-					localHighLow.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::local_highs_and_lows(candle[i]->getLHL()), Alerts::EnumString::tag_category(Alerts::TagCategory::OptionLocalHighsAndLows)}]);
-					underlyingPriceDelta.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::price_delta(candle[i]->getUnderlyingPriceDelta()), Alerts::EnumString::tag_category(Alerts::TagCategory::UnderlyingPriceDelta)}]);
-					underlyingDHL.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::daily_highs_and_lows(candle[i]->getUnderlyingDHL()), Alerts::EnumString::tag_category(Alerts::TagCategory::UnderlyingDailyHighsAndLows)}]);
-					underlyingLHL.push_back(Alerts::TagDBInterface::tagToInt[{Alerts::EnumString::local_highs_and_lows(candle[i]->getUnderlyingLHL()), Alerts::EnumString::tag_category(Alerts::TagCategory::UnderlyingLocalHighsAndLows)}]);
+					// Table ids are offsets from each packed tag, no string lookups needed
+					Alerts::TagWord tags = candle[i]->tagWord();
+					timeFrame.push_back(tags.dbId(Alerts::TagCategory::TimeFrame));
+					optionType.push_back(tags.dbId(Alerts::TagCategory::OptionType));
+					timeOfDay.push_back(tags.dbId(Alerts::TagCategory::TimeOfDay));
+					relativeToMoney.push_back(tags.dbId(Alerts::TagCategory::RelativeToMoney));
+					volumeStDev.push_back(tags.dbId(Alerts::TagCategory::VolumeStDev));
+					volumeThreshold.push_back(tags.dbId(Alerts::TagCategory::VolumeThreshold));
+					optPriceDelta.push_back(tags.dbId(Alerts::TagCategory::OptionPriceDelta));
+					dailyHighLow.push_back(tags.dbId(Alerts::TagCategory::OptionDailyHighsAndLows));
+					localHighLow.push_back(tags.dbId(Alerts::TagCategory::OptionLocalHighsAndLows));
+					underlyingPriceDelta.push_back(tags.dbId(Alerts::TagCategory::UnderlyingPriceDelta));
+					underlyingDHL.push_back(tags.dbId(Alerts::TagCategory::UnderlyingDailyHighsAndLows));
+					underlyingLHL.push_back(tags.dbId(Alerts::TagCategory::UnderlyingLocalHighsAndLows));
 				}
 
 				stmt.bind(0, reqId.data(), elements);
@@ -472,5 +476,121 @@ namespace OptionDB {
 				OPTIONSCANNER_ERROR("Error in CandlePerformance Insertion: {}", e.what());
 			}
 		}
+
+		// Loads every alert with a recorded outcome into the cube once, queries on it then run in memory
+		inline size_t loadCube(nanodbc::connection conn, Alerts::TagCube& cube) {
+			size_t loaded = 0;
+			nanodbc::statement stmt(conn);
+
+			stmt.prepare("SELECT c.TimeFrame, c.OptionType, c.TimeOfDay, c.RelativeToMoney, c.VolumeStDev, c.VolumeThreshold,"
+				"c.OptPriceDelta, c.DailyHighLow, c.LocalHighLow, c.UnderlyingPriceDelta, c.UnderlyingDailyHighLow,"
+				"c.UnderlyingLocalHighLow, p.WinLoss, p.PercentWin "
+				"FROM CandlePerformance p JOIN OptionCandles c ON p.CandleID = c.CandleID");
+
+			try {
+				nanodbc::result res = stmt.execute();
+
+				while (res.next()) {
+					// Each tag column holds an AlertTags table id, which maps straight onto its field
+					Alerts::TagWord tags;
+					for (short i = 0; i < static_cast<short>(Alerts::kNumTagCategories); i++) tags.setDbId(res.get<int>(i));
+
+					cube.add(tags, res.get<double>("WinLoss"), res.get<double>("PercentWin"));
+					loaded++;
+				}
+
+				OPTIONSCANNER_DEBUG("Loaded {} alert outcomes into the tag cube", loaded);
+			}
+			catch (const std::exception& e) {
+				OPTIONSCANNER_ERROR("Error: {}", e.what());
+			}
+
+			return loaded;
+		}
+	}
+
+	// Every horizon, target and stop of an alert's outcome grid, one row per cell
+	namespace CandleOutcomes {
+
+		inline void setTable(nanodbc::connection conn) {
+			try {
+				nanodbc::execute(conn, "DROP TABLE IF EXISTS CandleOutcomes");
+
+				string sql = "CREATE TABLE CandleOutcomes ("
+					"OutcomeID INT IDENTITY(1, 1) PRIMARY KEY,"
+					"CandleID INT NOT NULL,"
+					"Horizon INT NOT NULL,"
+					"Target DECIMAL(5,2) NOT NULL,"
+					"StopLoss DECIMAL(5,2) NOT NULL,"
+					"PercentWin DECIMAL(5,2) NOT NULL,"
+					"WinLoss DECIMAL(3,2) NOT NULL,"
+					"TimeToWin INT NOT NULL,"
+
+					"FOREIGN KEY (CandleID) REFERENCES OptionCandles(CandleID));";
+
+				nanodbc::execute(conn, sql);
+
+				OPTIONSCANNER_DEBUG("CandleOutcomes Table initialized");
+			}
+			catch (const std::exception& e) {
+				OPTIONSCANNER_ERROR("Error: {}", e.what());
+			}
+		}
+
+		inline void post(nanodbc::connection conn, std::vector<std::shared_ptr<Alerts::PerformanceResults>> alerts) {
+			try {
+				nanodbc::statement stmt(conn);
+
+				stmt.prepare("INSERT INTO CandleOutcomes (CandleID, Horizon, Target, StopLoss, PercentWin, WinLoss, TimeToWin)"
+					"VALUES (?, ?, ?, ?, ?, ?, ?)");
+
+				std::vector<int> candleId;
+				std::vector<long> horizon;
+				std::vector<double> target;
+				std::vector<double> stopLoss;
+				std::vector<double> percentWin;
+				std::vector<double> winLoss;
+				std::vector<long> timeToWin;
+
+				for (size_t i = 0; i < alerts.size(); i++) {
+					const Alerts::OutcomeMatrix& m = alerts[i]->outcomes;
+					if (m.empty()) continue;
+
+					const Alerts::OutcomeGrid& grid = m.grid();
+					for (size_t h = 0; h < grid.horizons.size(); h++) {
+						for (size_t t = 0; t < grid.targets.size(); t++) {
+							for (size_t s = 0; s < grid.stops.size(); s++) {
+								const Alerts::OutcomeResult& r = m.at(h, t, s);
+								candleId.push_back(alerts[i]->ct->getSqlId());
+								horizon.push_back(grid.horizons[h]);
+								target.push_back(grid.targets[t]);
+								stopLoss.push_back(grid.stops[s]);
+								percentWin.push_back(r.winLossPct);
+								winLoss.push_back(r.winLoss);
+								timeToWin.push_back(r.timeToWin);
+							}
+						}
+					}
+				}
+
+				size_t elements = candleId.size();
+				if (elements == 0) return;
+
+				stmt.bind(0, candleId.data(), elements);
+				stmt.bind(1, horizon.data(), elements);
+				stmt.bind(2, target.data(), elements);
+				stmt.bind(3, stopLoss.data(), elements);
+				stmt.bind(4, percentWin.data(), elements);
+				stmt.bind(5, winLoss.data(), elements);
+				stmt.bind(6, timeToWin.data(), elements);
+
+				nanodbc::transact(stmt, elements);
+
+				OPTIONSCANNER_DEBUG("CandleOutcomes Batch Insertion Successful");
+			}
+			catch (const std::exception& e) {
+				OPTIONSCANNER_ERROR("Error in CandleOutcomes Insertion: {}", e.what());
+			}
+		}
 	}
 }
\ No newline at end of file
@@ -46,8 +46,19 @@ namespace OptionDB {
 	}
 
 	void DatabaseManager::addToInsertionQueue(std::shared_ptr<Alerts::PerformanceResults> pfr) {
-		performanceQueue.push(pfr);
-		OPTIONSCANNER_DEBUG("Inserted to performance queue, current size: {}", performanceQueue.size());
+		std::unique_lock<std::mutex> lock(queueMtx);
+		performanceQueue.push_back(pfr);
+		size_t size = performanceQueue.size();
+		lock.unlock();
+		OPTIONSCANNER_DEBUG("Inserted to performance queue, current size: {}", size);
+	}
+
+	void DatabaseManager::addOutcomesToInsertionQueue(std::shared_ptr<Alerts::PerformanceResults> pfr) {
+		std::unique_lock<std::mutex> lock(queueMtx);
+		outcomeQueue.push_back(pfr);
+		size_t size = outcomeQueue.size();
+		lock.unlock();
+		OPTIONSCANNER_DEBUG("Inserted to outcome queue, current size: {}", size);
 	}
 
 	void DatabaseManager::resetCandleTables() {
@@ -63,6 +74,7 @@ namespace OptionDB {
 		UnderlyingTable::setTable(*conn_);
 		OptionTable::setTable(*conn_);
 		CandlePerformance::setTable(*conn_);
+		CandleOutcomes::setTable(*conn_);
 	}
 
 	void DatabaseManager::setAlertTables() {
@@ -77,12 +89,13 @@ namespace OptionDB {
 
 		while (true) {
 
-			while (!underlyingQueue.empty() || !candlePriorityQueue.empty() || !performanceQueue.empty()) {
+			while (!underlyingQueue.empty() || !candlePriorityQueue.empty() || resultsReady()) {
 				static long prevUnixTime = -1;
 				static bool unixTimeUpdated = false;
 
 				std::vector<std::shared_ptr<CandleTags>> optionBatch;
 				std::vector<std::shared_ptr<Alerts::PerformanceResults>> performanceBatch;
+				std::vector<std::shared_ptr<Alerts::PerformanceResults>> outcomeBatch;
 
 				if (!underlyingQueue.empty()) {
 					std::unique_lock<std::mutex> lock(queueMtx);
@@ -110,26 +123,43 @@ namespace OptionDB {
 				if (optionBatch.size() > 0) OptionDB::OptionTable::post(*conn_, optionBatch);
 				optionBatch.clear();
 
-				if (!performanceQueue.empty()) {
-					while (!performanceQueue.empty()) {
-						std::shared_ptr<Alerts::PerformanceResults> pf = performanceQueue.front();
-						performanceBatch.push_back(pf);
-						performanceQueue.pop();
-					}
-				}
+				// Results held back until their candle has its id, which the option batch above may have just given it
+				std::unique_lock<std::mutex> resultLock(queueMtx);
+				takePosted(performanceQueue, performanceBatch);
+				takePosted(outcomeQueue, outcomeBatch);
+				resultLock.unlock();
 
 				if (performanceBatch.size() > 0) OptionDB::CandlePerformance::post(*conn_, performanceBatch);
 				performanceBatch.clear();
+
+				if (outcomeBatch.size() > 0) OptionDB::CandleOutcomes::post(*conn_, outcomeBatch);
+				outcomeBatch.clear();
 			}
 
 			// Re-check stop-insertion after processing
 			if (stopInsertion) {
 				std::unique_lock<std::mutex> relock(queueMtx);
-				if (underlyingQueue.empty() && candlePriorityQueue.empty() && performanceQueue.empty()) break;
+				if (underlyingQueue.empty() && candlePriorityQueue.empty()) {
+					// Whatever is still held never had its candle posted and can't be
+					if (!performanceQueue.empty()) OPTIONSCANNER_ERROR("Dropping {} alert results without a posted candle", performanceQueue.size());
+					if (!outcomeQueue.empty()) OPTIONSCANNER_ERROR("Dropping {} alert outcome grids without a posted candle", outcomeQueue.size());
+					break;
+				}
 			}
 		}
 	}
 
+	bool DatabaseManager::resultsReady() {
+		std::lock_guard<std::mutex> lock(queueMtx);
+		for (const std::shared_ptr<Alerts::PerformanceResults>& pf : performanceQueue) {
+			if (pf->ct->getSqlId() != 0) return true;
+		}
+		for (const std::shared_ptr<Alerts::PerformanceResults>& pf : outcomeQueue) {
+			if (pf->ct->getSqlId() != 0) return true;
+		}
+		return false;
+	}
+
 	std::mutex& DatabaseManager::getMtx() { return queueMtx; }
 	std::condition_variable& DatabaseManager::getCV() { return cv; }
 }
\ No newline at end of file
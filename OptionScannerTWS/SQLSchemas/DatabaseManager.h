@@ -6,6 +6,7 @@
 #include "CandleRoutes.h"
 #include "AlertRoutes.h"
 
+#include <deque>
 #include <memory>
 #include <queue>
 #include <unordered_set>
@@ -20,6 +21,21 @@ struct candleTimeComparator {
 
 namespace OptionDB {
 
+	// Alert results reference their candle's OptionCandles row, so they can't be posted before it
+	// Moves the results whose candle has its sql id into the batch, the rest stay queued in order
+	inline void takePosted(std::deque<std::shared_ptr<Alerts::PerformanceResults>>& queue,
+		std::vector<std::shared_ptr<Alerts::PerformanceResults>>& batch) {
+		size_t kept = 0;
+		for (size_t i = 0; i < queue.size(); i++) {
+			if (queue[i]->ct->getSqlId() != 0) batch.push_back(std::move(queue[i]));
+			else {
+				if (kept != i) queue[kept] = std::move(queue[i]);
+				kept++;
+			}
+		}
+		queue.resize(kept);
+	}
+
 	class DatabaseManager {
 	public:
 		DatabaseManager();
@@ -31,6 +47,8 @@ namespace OptionDB {
 		void addToInsertionQueue(std::shared_ptr<CandleTags> ct);
 		void addToInsertionQueue(std::shared_ptr<Candle> c, TimeFrame tf);
 		void addToInsertionQueue(std::shared_ptr<Alerts::PerformanceResults> pfr);
+		// The alert's whole outcome grid, once every cell is final
+		void addOutcomesToInsertionQueue(std::shared_ptr<Alerts::PerformanceResults> pfr);
 
 		void resetCandleTables();
 
@@ -45,6 +63,7 @@ namespace OptionDB {
 
 	private:
 		void candleInsertionLoop();
+		bool resultsReady(); // Any queued result whose candle has been posted
 
 		std::shared_ptr<nanodbc::connection> conn_;
 
@@ -57,7 +76,9 @@ namespace OptionDB {
 		// Processing containers
 		std::queue<std::pair<UnderlyingTable::CandleForDB, TimeFrame>> underlyingQueue;
 		std::priority_queue<std::shared_ptr<CandleTags>, std::vector<std::shared_ptr<CandleTags>>, candleTimeComparator> candlePriorityQueue;
-		std::queue<std::shared_ptr<Alerts::PerformanceResults>> performanceQueue;
+		// Filled from the epoch workers and the alert thread, guarded by queueMtx
+		std::deque<std::shared_ptr<Alerts::PerformanceResults>> performanceQueue;
+		std::deque<std::shared_ptr<Alerts::PerformanceResults>> outcomeQueue;
 
 		// Keeps track of each time increment
 		std::unordered_set<long> timeSet;
@@ -0,0 +1,164 @@
+#include "SessionCalendar.h"
+
+namespace {
+    constexpr long kSecondsPerDay = 86400;
+
+    long floorDiv(long a, long b) { return (a >= 0) ? a / b : -((-a + b - 1) / b); }
+}
+
+SessionCalendar::SessionCalendar(int bucketMinutes, int openMinutes, int closeMinutes, int halfDayCloseMinutes,
+    int standardUtcOffsetMinutes, bool observesDst) :
+    bucketSeconds_((bucketMinutes > 0 ? bucketMinutes : 60) * 60), openMinutes_(openMinutes), closeMinutes_(closeMinutes),
+    halfDayCloseMinutes_(halfDayCloseMinutes), standardOffsetSeconds_(standardUtcOffsetMinutes * 60), observesDst_(observesDst) {}
+
+//====================================================
+// Lookups
+//====================================================
+
+int SessionCalendar::bucket(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+
+    if (unixTime < open_) return 0;
+    if (unixTime >= close_) return numBuckets() + 1;
+    return static_cast<int>((unixTime - open_) / bucketSeconds_) + 1;
+}
+
+int SessionCalendar::numBuckets() {
+    // A partial last bucket still counts, 8:30 to 15:00 is seven hourly buckets
+    int sessionSeconds = (closeMinutes_ - openMinutes_) * 60;
+    return (sessionSeconds + bucketSeconds_ - 1) / bucketSeconds_;
+}
+
+Alerts::TimeOfDay SessionCalendar::timeOfDay(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+
+    long hour = (unixTime > open_) ? (unixTime - open_) / 3600 : 0;
+    long last = static_cast<long>(Alerts::TimeOfDay::Hour7);
+    return static_cast<Alerts::TimeOfDay>(hour < last ? hour : last);
+}
+
+bool SessionCalendar::inSession(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+    return unixTime >= open_ && unixTime < close_;
+}
+
+long SessionCalendar::openTime(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+    return open_;
+}
+
+long SessionCalendar::closeTime(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+    return close_;
+}
+
+bool SessionCalendar::isHalfDay(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+    return halfDay_;
+}
+
+bool SessionCalendar::isClosed(long unixTime) {
+    if (unixTime < dayStart_ || unixTime >= dayEnd_) loadDay(unixTime);
+    return closed_;
+}
+
+void SessionCalendar::addHalfDay(int year, int month, int day) {
+    extraHalfDays_.insert(daysFromCivil(year, month, day));
+    dayEnd_ = 0; // Reload on the next lookup
+}
+
+void SessionCalendar::addClosedDay(int year, int month, int day) {
+    extraClosedDays_.insert(daysFromCivil(year, month, day));
+    dayEnd_ = 0;
+}
+
+int SessionCalendar::bucketMinutes() const { return bucketSeconds_ / 60; }
+
+void SessionCalendar::loadDay(long unixTime) {
+    // The local date decides daylight saving, which can in turn move the date near midnight
+    long days = floorDiv(unixTime + standardOffsetSeconds_, kSecondsPerDay);
+    int y, m, d;
+    civilFromDays(days, y, m, d);
+
+    long offset = standardOffsetSeconds_;
+    if (observesDst_ && isUsDst(y, m, d)) {
+        offset += 3600;
+        days = floorDiv(unixTime + offset, kSecondsPerDay);
+        civilFromDays(days, y, m, d);
+    }
+
+    dayStart_ = days * kSecondsPerDay - offset;
+    dayEnd_ = dayStart_ + kSecondsPerDay;
+
+    // A closed day is one empty session at the open, everything before it is pre open and after it post close
+    closed_ = isUsObservedHoliday(y, m, d) || extraClosedDays_.count(days) > 0;
+    halfDay_ = !closed_ && (isUsHalfDay(y, m, d) || extraHalfDays_.count(days) > 0);
+    open_ = dayStart_ + openMinutes_ * 60L;
+    close_ = closed_ ? open_ : dayStart_ + (halfDay_ ? halfDayCloseMinutes_ : closeMinutes_) * 60L;
+}
+
+//====================================================
+// Calendar Helpers
+//====================================================
+
+// Proleptic Gregorian conversions from Howard Hinnant's date algorithms
+long SessionCalendar::daysFromCivil(int year, int month, int day) {
+    long y = year - (month <= 2 ? 1 : 0);
+    long era = floorDiv(y, 400);
+    long yoe = y - era * 400;
+    long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void SessionCalendar::civilFromDays(long days, int& year, int& month, int& day) {
+    days += 719468;
+    long era = floorDiv(days, 146097);
+    long doe = days - era * 146097;
+    long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long mp = (5 * doy + 2) / 153;
+
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(yoe + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+int SessionCalendar::weekday(long days) {
+    // 1970-01-01 was a Thursday
+    long w = (days + 4) % 7;
+    return static_cast<int>(w < 0 ? w + 7 : w);
+}
+
+bool SessionCalendar::isUsDst(int year, int month, int day) {
+    // Second Sunday of March through the Saturday before the first Sunday of November
+    if (month < 3 || month > 11) return false;
+    if (month > 3 && month < 11) return true;
+
+    int firstSunday = 1 + (7 - weekday(daysFromCivil(year, month, 1))) % 7;
+    if (month == 3) return day >= firstSunday + 7;
+    return day < firstSunday;
+}
+
+bool SessionCalendar::isUsHalfDay(int year, int month, int day) {
+    int wd = weekday(daysFromCivil(year, month, day));
+    if (wd == 0 || wd == 6) return false;
+
+    // The day before Independence Day and Christmas Eve, unless the holiday is on a Saturday
+    // and is observed that Friday instead
+    if ((month == 7 && day == 3) || (month == 12 && day == 24)) return wd != 5;
+
+    // The day after Thanksgiving, the fourth Thursday of November
+    if (month == 11) {
+        int firstThursday = 1 + (4 - weekday(daysFromCivil(year, 11, 1)) + 7) % 7;
+        return day == firstThursday + 22;
+    }
+
+    return false;
+}
+
+bool SessionCalendar::isUsObservedHoliday(int year, int month, int day) {
+    // Independence Day and Christmas on a Saturday close the market the Friday before
+    if (weekday(daysFromCivil(year, month, day)) != 5) return false;
+    return (month == 7 && day == 3) || (month == 12 && day == 24);
+}
@@ -0,0 +1,74 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Trading session calendar
+// Maps a unix time to its bucket of the trading session in the
+// exchange's own timezone (US Central by default, with US daylight
+// saving), whatever timezone the host is in. The open, close and UTC
+// offset are worked out once per trading day, after which each lookup
+// is a subtraction and a division. Half days close early and closed
+// days have no session. The usual US half days and the Fridays closed
+// for an Independence Day or Christmas falling on a Saturday are built
+// in, the rest of the exchange's holiday list can be added
+//=======================================================================
+
+#pragma once
+
+#include <set>
+
+#include "Enums.h"
+
+class SessionCalendar {
+public:
+    // Times are minutes after local midnight, the offset is the exchange's standard time offset from UTC
+    explicit SessionCalendar(int bucketMinutes = 60, int openMinutes = 8 * 60 + 30, int closeMinutes = 15 * 60,
+        int halfDayCloseMinutes = 12 * 60, int standardUtcOffsetMinutes = -6 * 60, bool observesDst = true);
+
+    // 1 based bucket of the session, 0 before the open, numBuckets() + 1 from the close on
+    int bucket(long unixTime);
+    int numBuckets();
+
+    // Hourly tag for alerts, independent of the bucket width
+    // Times before the open count as the first hour and after the close as the last
+    Alerts::TimeOfDay timeOfDay(long unixTime);
+    bool inSession(long unixTime);
+
+    // Open and close of the trading day containing unixTime
+    long openTime(long unixTime);
+    long closeTime(long unixTime);
+    bool isHalfDay(long unixTime);
+    bool isClosed(long unixTime);
+
+    void addHalfDay(int year, int month, int day);
+    void addClosedDay(int year, int month, int day);
+    int bucketMinutes() const;
+
+    // Calendar helpers, days are counted from 1970-01-01
+    static long daysFromCivil(int year, int month, int day);
+    static void civilFromDays(long days, int& year, int& month, int& day);
+    static int weekday(long days); // 0 is Sunday
+    static bool isUsDst(int year, int month, int day);
+    static bool isUsHalfDay(int year, int month, int day);
+    static bool isUsObservedHoliday(int year, int month, int day); // Only the Saturday holidays observed on Friday
+
+private:
+    void loadDay(long unixTime);
+
+    int bucketSeconds_;
+    int openMinutes_;
+    int closeMinutes_;
+    int halfDayCloseMinutes_;
+    int standardOffsetSeconds_;
+    bool observesDst_;
+
+    std::set<long> extraHalfDays_;
+    std::set<long> extraClosedDays_;
+
+    // Current trading day in UTC seconds, loaded on the first lookup outside it
+    long dayStart_{ 1 };
+    long dayEnd_{ 0 };
+    long open_{ 0 };
+    long close_{ 0 };
+    bool halfDay_{ false };
+    bool closed_{ false };
+};
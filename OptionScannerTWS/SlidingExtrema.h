@@ -0,0 +1,57 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Sliding window extrema
+// Tracks the max (or min) of the last n values with a monotonic deque.
+// Each value is pushed and popped at most once, so updates are
+// amortized O(1) and the current extreme is always at the front
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <utility>
+
+template <typename Compare>
+class SlidingExtremum {
+public:
+    explicit SlidingExtremum(size_t window) : window_(window > 0 ? window : 1) {}
+
+    void push(double value) {
+        // Anything the new value beats can never be the extreme again
+        while (!values_.empty() && beats_(value, values_.back().second)) values_.pop_back();
+        values_.emplace_back(seq_, value);
+        seq_++;
+        expire();
+    }
+
+    // Extreme of the last window values, 0 before the first push
+    double value() const { return values_.empty() ? 0 : values_.front().second; }
+    bool empty() const { return values_.empty(); }
+
+    size_t window() const { return window_; }
+    void setWindow(size_t window) {
+        window_ = window > 0 ? window : 1;
+        expire();
+    }
+
+    void clear() {
+        values_.clear();
+        seq_ = 0;
+    }
+
+private:
+    void expire() {
+        while (!values_.empty() && values_.front().first + window_ < seq_) values_.pop_front();
+    }
+
+    size_t window_;
+    size_t seq_{ 0 };
+    std::deque<std::pair<size_t, double>> values_; // Sequence number and value, extreme first
+    Compare beats_;
+};
+
+using SlidingMax = SlidingExtremum<std::greater_equal<double>>;
+using SlidingMin = SlidingExtremum<std::less_equal<double>>;
@@ -0,0 +1,124 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Packed alert tags
+// Every tag enum has only a handful of values, so a full combination of
+// tags fits in a single 64 bit word. Each TagCategory owns a fixed bit
+// field, sized and placed at compile time from the number of values in
+// its enum. Comparing, hashing and keying stats on a tag combination is
+// then one integer operation, and the AlertTags table ids used by the db
+// are an offset from each field rather than a string lookup
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#include "Enums.h"
+
+namespace Alerts {
+
+    // Values in each tag enum, in TagCategory order
+    constexpr int kTagValues[] = {
+        2,  // OptionType
+        4,  // TimeFrame
+        11, // RelativeToMoney
+        7,  // TimeOfDay
+        5,  // VolumeStDev
+        5,  // VolumeThreshold
+        3,  // UnderlyingPriceDelta
+        3,  // OptionPriceDelta
+        3,  // UnderlyingDailyHighsAndLows
+        3,  // OptionDailyHighsAndLows
+        3,  // UnderlyingLocalHighsAndLows
+        3,  // OptionLocalHighsAndLows
+    };
+
+    constexpr size_t kNumTagCategories = sizeof(kTagValues) / sizeof(kTagValues[0]);
+
+    namespace TagFields {
+        constexpr size_t index(TagCategory c) { return static_cast<size_t>(c); }
+
+        // Bits needed to hold every value of a category
+        constexpr int width(size_t i) {
+            int bits = 0;
+            while ((1 << bits) < kTagValues[i]) bits++;
+            return bits;
+        }
+
+        // Fields are packed from bit 0 in TagCategory order
+        constexpr int offset(size_t i) {
+            int bits = 0;
+            for (size_t j = 0; j < i; j++) bits += width(j);
+            return bits;
+        }
+
+        constexpr uint64_t mask(size_t i) { return ((uint64_t(1) << width(i)) - 1) << offset(i); }
+
+        // AlertTags table ids run from 1 through each category in TagCategory order
+        constexpr int dbBase(size_t i) {
+            int id = 1;
+            for (size_t j = 0; j < i; j++) id += kTagValues[j];
+            return id;
+        }
+
+        constexpr int kUsedBits = offset(kNumTagCategories);
+        constexpr int kNumDbIds = dbBase(kNumTagCategories) - 1;
+    }
+
+    static_assert(TagFields::kUsedBits <= 64, "Tag fields must fit in one 64 bit word");
+    static_assert(TagFields::kNumDbIds == 52, "AlertTags table ids must match the tag enums");
+
+    class TagWord {
+    public:
+        constexpr TagWord() = default;
+        constexpr explicit TagWord(uint64_t bits) : bits_(bits) {}
+
+        // Raw enum value stored for a category
+        constexpr int value(TagCategory c) const {
+            return static_cast<int>((bits_ & TagFields::mask(TagFields::index(c))) >> TagFields::offset(TagFields::index(c)));
+        }
+
+        template <typename E>
+        constexpr E get(TagCategory c) const { return static_cast<E>(value(c)); }
+
+        template <typename E>
+        TagWord& set(TagCategory c, E val) {
+            size_t i = TagFields::index(c);
+            bits_ = (bits_ & ~TagFields::mask(i)) | ((static_cast<uint64_t>(val) << TagFields::offset(i)) & TagFields::mask(i));
+            return *this;
+        }
+
+        // AlertTags table id for the value held in a category
+        constexpr int dbId(TagCategory c) const { return TagFields::dbBase(TagFields::index(c)) + value(c); }
+
+        // Sets whichever category an AlertTags table id belongs to, ids out of range are ignored
+        TagWord& setDbId(int id) {
+            for (size_t i = 0; i < kNumTagCategories; i++) {
+                if (id >= TagFields::dbBase(i) && id < TagFields::dbBase(i + 1)) {
+                    return set(static_cast<TagCategory>(i), id - TagFields::dbBase(i));
+                }
+            }
+            return *this;
+        }
+
+        constexpr uint64_t bits() const { return bits_; }
+
+    private:
+        uint64_t bits_{ 0 };
+    };
+
+    // Ordering has no meaning beyond being total, it only serves ordered containers
+    constexpr bool operator==(TagWord left, TagWord right) { return left.bits() == right.bits(); }
+    constexpr bool operator!=(TagWord left, TagWord right) { return left.bits() != right.bits(); }
+    constexpr bool operator<(TagWord left, TagWord right) { return left.bits() < right.bits(); }
+}
+
+namespace std {
+    template <>
+    struct hash<Alerts::TagWord> {
+        size_t operator()(Alerts::TagWord tags) const { return std::hash<uint64_t>()(tags.bits()); }
+    };
+}
@@ -0,0 +1,100 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Open addressing table keyed on packed tags
+// Keys and values sit side by side in one flat array and collisions
+// probe the next slot, so a lookup is usually one hash and one cache
+// line. Tag words only use the low TagFields::kUsedBits bits, which
+// leaves an all ones word free to mark empty slots. Entries are never
+// removed, stats only ever accumulate
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "TagWord.h"
+
+template <typename V>
+class TagWordTable {
+public:
+    // Capacity is rounded up to the next power of two
+    explicit TagWordTable(size_t capacity = 64) { rehash(capacity); }
+
+    // Value for a tag combination, inserted as V() the first time
+    V& operator[](Alerts::TagWord key) {
+        if ((size_ + 1) * 4 > slots_.size() * 3) rehash(slots_.size() * 2);
+
+        size_t i = probe(key.bits());
+        if (slots_[i].key == kEmpty) {
+            slots_[i].key = key.bits();
+            slots_[i].value = V();
+            size_++;
+        }
+        return slots_[i].value;
+    }
+
+    // nullptr if the combination has never been seen
+    const V* find(Alerts::TagWord key) const {
+        const Slot& slot = slots_[probe(key.bits())];
+        return slot.key == kEmpty ? nullptr : &slot.value;
+    }
+
+    // Visits every combination seen, in no particular order
+    template <typename F>
+    void forEach(F&& func) const {
+        for (const Slot& slot : slots_) {
+            if (slot.key != kEmpty) func(Alerts::TagWord(slot.key), slot.value);
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr uint64_t kEmpty = ~uint64_t(0);
+    static_assert(Alerts::TagFields::kUsedBits < 64, "The empty key must not be a valid tag word");
+
+    struct Slot {
+        uint64_t key{ kEmpty };
+        V value;
+    };
+
+    // Spreads the tag fields over the whole word before masking, the low fields alone cluster badly
+    static size_t hash(uint64_t bits) {
+        bits ^= bits >> 33;
+        bits *= 0xff51afd7ed558ccdULL;
+        bits ^= bits >> 33;
+        return static_cast<size_t>(bits);
+    }
+
+    // Slot holding key, or the empty slot it would go in
+    size_t probe(uint64_t key) const {
+        size_t mask = slots_.size() - 1;
+        size_t i = hash(key) & mask;
+        while (slots_[i].key != kEmpty && slots_[i].key != key) i = (i + 1) & mask;
+        return i;
+    }
+
+    void rehash(size_t capacity) {
+        size_t size = 8;
+        while (size < capacity) size <<= 1;
+
+        std::vector<Slot> old(size);
+        old.swap(slots_);
+        for (Slot& slot : old) {
+            if (slot.key != kEmpty) {
+                Slot& dest = slots_[probe(slot.key)];
+                dest.key = slot.key;
+                dest.value = std::move(slot.value);
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    size_t size_{ 0 };
+};
@@ -0,0 +1,135 @@
+#include "TickBarBuilder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+TickBarBuilder::TickBarBuilder(int subBarSeconds, int epochSeconds) :
+    subBarSeconds_(1), epochSeconds_(std::max(1, epochSeconds)) {
+    setSubBarSeconds(subBarSeconds);
+}
+
+void TickBarBuilder::setCallbacks(BarCallback onSubBar, BarCallback onEpochBar) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    onSubBar_ = std::move(onSubBar);
+    onEpochBar_ = std::move(onEpochBar);
+}
+
+void TickBarBuilder::setSubBarSeconds(int seconds) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    seconds = std::min(std::max(1, seconds), epochSeconds_);
+    while (epochSeconds_ % seconds != 0) seconds--;
+    subBarSeconds_ = seconds;
+}
+
+int TickBarBuilder::subBarSeconds() const {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    return subBarSeconds_;
+}
+
+void TickBarBuilder::track(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    series_[reqId];
+}
+
+void TickBarBuilder::untrack(TickerId reqId) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    series_.erase(reqId);
+}
+
+bool TickBarBuilder::isTracked(TickerId reqId) const {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    return series_.count(reqId) > 0;
+}
+
+bool TickBarBuilder::trade(TickerId reqId, const RtVolume& trade) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    auto it = series_.find(reqId);
+    if (it == series_.end()) return false;
+
+    Series& s = it->second;
+    double price = trade.price > 0 ? trade.price : s.lastPrice;
+    // A size without any price yet cannot be placed in a bar
+    if (price <= 0) return true;
+
+    long now = static_cast<long>(trade.timeMs / 1000);
+    if (now < s.epoch.start) now = s.epoch.start;
+    if (now < s.sub.start) now = s.sub.start;
+    roll(reqId, s, now);
+
+    if (s.sub.start < 0) open(s.sub, now - now % subBarSeconds_, price);
+    if (s.epoch.start < 0) open(s.epoch, now - now % epochSeconds_, price);
+
+    if (trade.price > 0) {
+        add(s.sub, price, trade.size);
+        add(s.epoch, price, trade.size);
+        s.lastPrice = price;
+    }
+    else {
+        s.sub.volume += trade.size;
+        s.epoch.volume += trade.size;
+    }
+
+    return true;
+}
+
+void TickBarBuilder::flush(long long nowMs) {
+    std::lock_guard<std::mutex> lock(builderMtx_);
+    long now = static_cast<long>(nowMs / 1000);
+    for (auto& it : series_) roll(it.first, it.second, now);
+}
+
+void TickBarBuilder::roll(TickerId reqId, Series& s, long now) {
+    long subStart = now - now % subBarSeconds_;
+    if (s.sub.start >= 0 && s.sub.start < subStart) {
+        if (onSubBar_) onSubBar_(Candle(reqId, s.sub.start, s.sub.open, s.sub.high, s.sub.low, s.sub.close, s.sub.volume, 0.0, s.sub.count));
+        s.sub = Bar();
+    }
+
+    long epochStart = now - now % epochSeconds_;
+    if (s.epoch.start >= 0 && s.epoch.start < epochStart) {
+        if (onEpochBar_) onEpochBar_(Candle(reqId, s.epoch.start, s.epoch.open, s.epoch.high, s.epoch.low, s.epoch.close, s.epoch.volume, 0.0, s.epoch.count));
+
+        // Quiet contracts still report a flat bar each epoch, as realtime bars do
+        open(s.epoch, epochStart, s.lastPrice);
+    }
+}
+
+void TickBarBuilder::open(Bar& bar, long start, double price) {
+    bar = Bar();
+    bar.start = start;
+    bar.open = bar.high = bar.low = bar.close = price;
+}
+
+void TickBarBuilder::add(Bar& bar, double price, long size) {
+    bar.high = std::max(bar.high, price);
+    bar.low = std::min(bar.low, price);
+    bar.close = price;
+    bar.volume += size;
+    bar.count++;
+}
+
+bool parseRtVolume(const std::string& value, RtVolume& out) {
+    // Only the first three fields are needed
+    size_t first = value.find(';');
+    if (first == std::string::npos) return false;
+    size_t second = value.find(';', first + 1);
+    if (second == std::string::npos) return false;
+    size_t third = value.find(';', second + 1);
+
+    const char* p = value.c_str();
+    char* end = nullptr;
+
+    out.price = 0;
+    if (first > 0) {
+        out.price = std::strtod(p, &end);
+        if (end != p + first) return false;
+    }
+
+    out.size = std::strtol(p + first + 1, &end, 10);
+    if (end != p + second) return false;
+
+    out.timeMs = std::strtoll(p + second + 1, &end, 10);
+    if (end == p + second + 1 || (third != std::string::npos && end != p + third)) return false;
+
+    return true;
+}
@@ -0,0 +1,89 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Tick bar builder
+// Builds bars in process from the RT_VOLUME ticks (generic tick 233) of
+// contracts streamed with reqMktData. Each RT_VOLUME tick is one trade
+// print with its price, size and server timestamp, unlike LAST_SIZE which
+// TWS repeats after every LAST and also sends on its own, so volume is
+// counted once. Each completed sub bar (1 second by default) goes to
+// onSubBar so a volume spike is visible before the 5 second bar closes,
+// and each epoch a full bar goes to onEpochBar to follow the same path as
+// a realtime bar. Trades are bucketed on their server timestamp, so
+// flush must be driven by the server clock as well, see tWrapper
+//=======================================================================
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "Candle.h"
+
+// One RT_VOLUME tick, "price;size;time;totalVolume;vwap;singleTrade"
+// price is 0 when the field is empty, which TWS sends for volume only updates
+struct RtVolume {
+    double price{ 0 };
+    long size{ 0 };
+    long long timeMs{ 0 };
+};
+
+// False if value is not a well formed RT_VOLUME string
+bool parseRtVolume(const std::string& value, RtVolume& out);
+
+class TickBarBuilder {
+public:
+    using BarCallback = std::function<void(Candle&&)>;
+
+    // subBarSeconds is rounded down to a divisor of epochSeconds
+    TickBarBuilder(int subBarSeconds = 1, int epochSeconds = 5);
+
+    void setCallbacks(BarCallback onSubBar, BarCallback onEpochBar);
+    void setSubBarSeconds(int seconds);
+    int subBarSeconds() const;
+
+    // Only tracked reqIds are built into bars, snapshots share the same callbacks
+    void track(TickerId reqId);
+    void untrack(TickerId reqId);
+    bool isTracked(TickerId reqId) const;
+
+    // Wrapper side, returns false if the reqId is not tracked
+    // A trade older than the bar already open, ie one that arrived after a flush closed its bar, joins the open bar
+    bool trade(TickerId reqId, const RtVolume& trade);
+
+    // Closes every bar whose interval has ended, called periodically so quiet contracts still
+    // produce a flat bar each epoch once their first price is known. nowMs is server time
+    void flush(long long nowMs);
+
+private:
+    struct Bar {
+        long start{ -1 };
+        double open{ 0 };
+        double high{ 0 };
+        double low{ 0 };
+        double close{ 0 };
+        long volume{ 0 };
+        int count{ 0 };
+    };
+
+    struct Series {
+        Bar sub;
+        Bar epoch;
+        double lastPrice{ 0 };
+    };
+
+    void roll(TickerId reqId, Series& s, long now);
+    static void open(Bar& bar, long start, double price);
+    static void add(Bar& bar, double price, long size);
+
+    int subBarSeconds_;
+    const int epochSeconds_;
+
+    BarCallback onSubBar_;
+    BarCallback onEpochBar_;
+
+    std::unordered_map<TickerId, Series> series_;
+    mutable std::mutex builderMtx_; // Ticks arrive on the EReader thread, flush on the scanner thread
+};
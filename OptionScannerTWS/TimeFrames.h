@@ -0,0 +1,87 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Timeframe ladder
+// Every timeframe ContractData builds is listed once here, smallest
+// first. The first entry is the bar received from TWS and each later
+// entry is rolled up from it. Storage, statistics and tags are held in
+// PerTimeFrame arrays generated from this list, so a TimeFrame maps
+// straight to an array index and adding a timeframe only needs a new
+// enum value and a row below
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <utility>
+
+#include "Enums.h"
+
+struct TimeFrameSpec {
+    TimeFrame tf;
+    int seconds;
+    size_t capacity;    // Candles kept in memory
+    size_t minCapacity; // Lowest capacity setSeriesCapacity allows
+    size_t warmup;      // Candles seen before the stdev tags are updated
+};
+
+// The 5 second series keeps at least 30 minutes for alert outcomes, the
+// others hold enough for the session. Warmups are about 30 minutes each
+constexpr TimeFrameSpec kTimeFrames[] = {
+    { TimeFrame::FiveSecs, 5, 720, 360, 360 },
+    { TimeFrame::ThirtySecs, 30, 240, 1, 60 },
+    { TimeFrame::OneMin, 60, 240, 1, 30 },
+    { TimeFrame::FiveMin, 300, 84, 1, 7 },
+};
+
+constexpr size_t kNumTimeFrames = sizeof(kTimeFrames) / sizeof(kTimeFrames[0]);
+
+namespace TimeFrames {
+    // Enum values must be ladder positions, and each timeframe must close on a boundary of the one below
+    constexpr bool ladderIsValid() {
+        for (size_t i = 0; i < kNumTimeFrames; i++) {
+            if (static_cast<size_t>(kTimeFrames[i].tf) != i) return false;
+            if (i > 0 && kTimeFrames[i].seconds % kTimeFrames[i - 1].seconds != 0) return false;
+        }
+        return true;
+    }
+}
+
+static_assert(TimeFrames::ladderIsValid(), "kTimeFrames must follow the TimeFrame enum order and nest evenly");
+
+constexpr size_t tfIndex(TimeFrame tf) { return static_cast<size_t>(tf); }
+constexpr TimeFrame tfAt(size_t i) { return kTimeFrames[i].tf; }
+constexpr const TimeFrameSpec& tfSpec(TimeFrame tf) { return kTimeFrames[tfIndex(tf)]; }
+
+// Base bars that make up one bar of the ladder entry at i
+constexpr size_t baseBarsIn(size_t i) { return static_cast<size_t>(kTimeFrames[i].seconds / kTimeFrames[0].seconds); }
+
+// One T per timeframe on the ladder, indexed directly by TimeFrame
+template <typename T>
+class PerTimeFrame {
+public:
+    PerTimeFrame() = default;
+
+    // Builds each entry from its spec, for types without a default constructor
+    template <typename Make>
+    static PerTimeFrame build(Make make) { return PerTimeFrame(make, std::make_index_sequence<kNumTimeFrames>()); }
+
+    T& operator[](TimeFrame tf) { return values_[tfIndex(tf)]; }
+    const T& operator[](TimeFrame tf) const { return values_[tfIndex(tf)]; }
+
+    T& at(size_t i) { return values_[i]; }
+    const T& at(size_t i) const { return values_[i]; }
+
+    static constexpr size_t size() { return kNumTimeFrames; }
+
+    T* begin() { return values_; }
+    T* end() { return values_ + kNumTimeFrames; }
+    const T* begin() const { return values_; }
+    const T* end() const { return values_ + kNumTimeFrames; }
+
+private:
+    template <typename Make, size_t... I>
+    PerTimeFrame(Make& make, std::index_sequence<I...>) : values_{ make(kTimeFrames[I])... } {}
+
+    T values_[kNumTimeFrames]{};
+};
@@ -0,0 +1,138 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Hashed timer wheel
+// Values are filed into the slot of the tick their deadline falls on,
+// so scheduling and expiring are O(1) per value however many are
+// outstanding. Deadlines further out than one turn of the wheel share
+// a slot with nearer ones and stay put until their own turn comes. A
+// bitmap of occupied slots gives the next tick worth waking for, which
+// lets the owner sleep on a condition variable until then. Not thread
+// safe, the owner holds its own lock
+//=======================================================================
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Slot count is rounded up to the next multiple of 64, deadlines are rounded up to the tick
+    TimerWheel(Clock::duration tick, size_t slots, Clock::time_point start = Clock::now()) :
+        tick_(tick), start_(start) {
+        size_t words = (slots + 63) / 64;
+        if (words == 0) words = 1;
+        slots_.resize(words * 64);
+        occupied_.assign(words, 0);
+    }
+
+    void schedule(T value, Clock::time_point deadline) {
+        int64_t tick = tickOf(deadline, true);
+        if (tick < current_) tick = current_; // Already due, fires on the next expire
+
+        size_t slot = static_cast<size_t>(tick) % slots_.size();
+        slots_[slot].push_back({ tick, std::move(value) });
+        occupied_[slot / 64] |= uint64_t(1) << (slot % 64);
+        size_++;
+    }
+
+    // Hands every value due at or before now to func, in tick order and in scheduling order
+    // within a tick, unless the wheel fell a full turn behind. Returns the number expired
+    template <typename F>
+    size_t expire(Clock::time_point now, F&& func) {
+        int64_t nowTick = tickOf(now, false);
+        if (nowTick < current_) return 0;
+
+        // One turn visits every slot, anything left after that belongs to a later turn
+        int64_t last = nowTick - current_ >= static_cast<int64_t>(slots_.size()) ?
+            current_ + static_cast<int64_t>(slots_.size()) - 1 : nowTick;
+
+        size_t expired = 0;
+        for (int64_t tick = current_; tick <= last; tick++) {
+            size_t slot = static_cast<size_t>(tick) % slots_.size();
+            if (!(occupied_[slot / 64] & (uint64_t(1) << (slot % 64)))) continue;
+
+            std::vector<Entry>& entries = slots_[slot];
+            size_t kept = 0;
+            for (size_t i = 0; i < entries.size(); i++) {
+                if (entries[i].tick <= nowTick) {
+                    func(std::move(entries[i].value));
+                    expired++;
+                }
+                else {
+                    if (kept != i) entries[kept] = std::move(entries[i]);
+                    kept++;
+                }
+            }
+            entries.erase(entries.begin() + kept, entries.end());
+            if (entries.empty()) occupied_[slot / 64] &= ~(uint64_t(1) << (slot % 64));
+        }
+
+        size_ -= expired;
+        current_ = nowTick + 1;
+        return expired;
+    }
+
+    // Start of the first occupied tick, never later than the earliest deadline
+    // A slot holding only later turns makes this early, the owner just waits again
+    // Clock::time_point::max() when nothing is scheduled
+    Clock::time_point nextDeadline() const {
+        if (size_ == 0) return Clock::time_point::max();
+
+        size_t slots = slots_.size();
+        size_t first = static_cast<size_t>(current_) % slots;
+        for (size_t offset = 0; offset < slots;) {
+            size_t slot = (first + offset) % slots;
+            uint64_t word = occupied_[slot / 64] >> (slot % 64);
+
+            if (word == 0) {
+                offset += 64 - slot % 64; // Nothing else in this word
+                continue;
+            }
+
+            size_t bit = 0;
+            while (!(word & 1)) {
+                word >>= 1;
+                bit++;
+            }
+            offset += bit;
+            if (offset >= slots) break;
+            return start_ + tick_ * (current_ + static_cast<int64_t>(offset));
+        }
+
+        return start_ + tick_ * current_;
+    }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t slots() const { return slots_.size(); }
+    Clock::duration tick() const { return tick_; }
+
+private:
+    struct Entry {
+        int64_t tick;
+        T value;
+    };
+
+    int64_t tickOf(Clock::time_point t, bool roundUp) const {
+        Clock::duration since = t - start_;
+        int64_t tick = since / tick_;
+        if (roundUp && tick_ * tick < since) tick++;
+        return tick;
+    }
+
+    Clock::duration tick_;
+    Clock::time_point start_;
+    int64_t current_{ 0 }; // Every tick before this one has been expired
+
+    std::vector<std::vector<Entry>> slots_;
+    std::vector<uint64_t> occupied_;
+    size_t size_{ 0 };
+};
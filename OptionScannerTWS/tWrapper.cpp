@@ -5,9 +5,28 @@
 // Wrapper for TWS API
 //====================================================
 
-tWrapper::tWrapper(int initBufferSize, bool runEReader) : candleBuffer_{ initBufferSize }, EWrapperL0(runEReader) { // Size 19 for 8 calls, 8 puts, and one underlying
+tWrapper::tWrapper(bool runEReader) : EWrapperL0(runEReader) {
     m_Done = false;
     m_ErrorForRequest = false;
+
+    // Bars built from ticks are stamped with their slot the same way realtime bars are
+    tickBars_.setCallbacks(
+        [this](Candle&& c) {
+            c.setSlot(contracts_.slotOf(c.reqId()));
+            subBars_.tryPush(c.toRealtimeBar());
+        },
+        [this](Candle&& c) {
+            c.setSlot(contracts_.slotOf(c.reqId()));
+            candleBuffer_.publish(c.toRealtimeBar());
+            cv_.notify_one();
+        });
+}
+
+namespace {
+    long long nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
 }
 
 //==================== Error Handling ========================
@@ -19,10 +38,15 @@ void tWrapper::winError(const IBString& str, int lastError) {
 }
 
 void tWrapper::error(const int id, const int errorCode, const IBString errorString) {
+    if (auto journal = std::atomic_load(&journal_)) journal->appendError(id, errorCode, (const char*)errorString);
+
     if (errorCode != 2176) { // 2176 is a weird api error that claims to not allow use of fractional shares
         fprintf(stderr, "Error for id=%d: %d = %s\n"
             , id, errorCode, (const char*)errorString);
         m_ErrorForRequest = (id > 0);    // id == -1 are 'system' messages, not for user requests
+
+        // Fail the matching future, if any, so the caller is not left waiting
+        if (id > 0 && isRequestFailure(errorCode)) requests_.fail(id, errorCode, std::string(errorString));
     }
 }
 
@@ -43,10 +67,17 @@ void tWrapper::managedAccounts(const IBString& accountsList) { std::cout << acco
 
 // ================== tWrapper callback functions =======================
 
-void tWrapper::currentTime(long time) { time_ = time; }
+void tWrapper::currentTime(long time) {
+    // The server reports whole seconds, half a second centres the estimate of its clock
+    clockOffsetMs_ = static_cast<long long>(time) * 1000 + 500 - nowMs();
+    time_ = time;
+}
 
 void tWrapper::tickPrice(TickerId tickerId, TickType field, double price, int canAutoExecute) {
+    if (auto journal = std::atomic_load(&journal_)) journal->appendTickPrice(tickerId, field, price, canAutoExecute);
+
     if (field == TickType::LAST) tickPriceLast_ = price;
+    requests_.snapshotTick(tickerId, field, price);
     // std::cout << "Field: " << field << " Price: " << price << std::endl;
 }
 
@@ -55,6 +86,8 @@ void tWrapper::tickGeneric(TickerId tickerId, TickType tickType, double value) {
 }
 
 void tWrapper::tickSize(TickerId tickerId, TickType field, int size) {
+    if (auto journal = std::atomic_load(&journal_)) journal->appendTickSize(tickerId, field, size);
+
     //std::cout << "Tick Size: " << size << std::endl;
 }
 
@@ -63,11 +96,17 @@ void tWrapper::marketDataType(TickerId reqId, int marketDataType) {
 }
 
 void tWrapper::tickString(TickerId tickerId, TickType tickType, const IBString& value) {
+    if (auto journal = std::atomic_load(&journal_)) journal->appendTickString(tickerId, tickType, (const char*)value);
+
+    // Tick bars are built from trade prints only, LAST_SIZE repeats the size of each LAST
+    RtVolume trade;
+    if (tickType == TickType::RT_VOLUME && parseRtVolume(std::string(value), trade)) tickBars_.trade(tickerId, trade);
     // std::cout << "Value: " << value << std::endl;
 }
 
 void tWrapper::tickSnapshotEnd(int reqId) {
     Req_ = reqId;
+    requests_.snapshotEnd(reqId);
 }
 
 void tWrapper::historicalData(TickerId reqId, const IBString& date
@@ -79,6 +118,7 @@ void tWrapper::historicalData(TickerId reqId, const IBString& date
         // m_Done = true;
         // Set Req to the same value as reqId so we can retrieve the data once finished
         Req_ = reqId;
+        requests_.historicalEnd(reqId);
         std::cout << "Completed historical data request " << Req_ << std::endl;
         return;
     }
@@ -89,7 +129,10 @@ void tWrapper::historicalData(TickerId reqId, const IBString& date
     std::unique_ptr<Candle> c = std::make_unique<Candle>(
         reqId, date, open, high, low, close, vol, barCount, WAP, hasGaps
         );
-    historicCandles_.push_back(std::move(c));
+
+    // Registered requests collect their own bars, anything else goes to the shared container
+    // Checked and handed over under one lock so the request can't complete in between
+    if (!requests_.historicalBar(reqId, c)) historicCandles_.push_back(std::move(c));
 
     if (showHistoricalData_) {
         fprintf(stdout, "%10s, %5.3f, %5.3f, %5.3f, %5.3f, %7d\n"
@@ -100,114 +143,131 @@ void tWrapper::historicalData(TickerId reqId, const IBString& date
 void tWrapper::realtimeBar(TickerId reqId, long time, double open, double high,
     double low, double close, long volume, double wap, int count) {
 
+    if (auto journal = std::atomic_load(&journal_)) journal->appendRealtimeBar(reqId, time, open, high, low, close, volume, wap, count);
+
     if (showRealTimeData_) {
         std::cout << reqId << " " << time << " " << "high: " << high << " low: " << low << " volume: " << volume << std::endl;
     }
 
     // ReqId 1234 will be used for the underlying contract
     // Along with the other option strike reqs to fill the buffer
-    std::lock_guard<std::mutex> lock(wrapperMtx_);
-    // Upon receiving the price request, populate Candle data
-    std::unique_ptr<Candle> c = std::make_unique<Candle>(
-        reqId, time, open, high, low, close, volume, wap, count
-        );
+    // Publishing never blocks, if the scanner falls behind the bar is dropped and counted
+    candleBuffer_.publish(RealtimeBar::make(reqId, time, open, high, low, close, volume, contracts_.slotOf(reqId)));
 
-    if (activeReqs_.find(reqId) == activeReqs_.end()) activeReqs_.insert(reqId);
-    //std::cout << "Current Active Reqs: " << activeReqs_.size() << std::endl;
+    cv_.notify_one();
+}
 
-    candleBuffer_.wrapperActiveReqs = activeReqs_.size();
-    candleBuffer_.updateBuffer(std::move(c));
+void tWrapper::contractDetails(int reqId, const ContractDetails& contractDetails) {
+    requests_.contractDetails(reqId, contractDetails);
+}
 
-    cv_.notify_one();
+void tWrapper::contractDetailsEnd(int reqId) {
+    requests_.contractDetailsEnd(reqId);
+}
+
+// ========================= tWrapper Recording ===========================
+
+void tWrapper::startRecording(const std::string& path) {
+    std::atomic_store(&journal_, std::make_shared<JournalWriter>(path));
+    std::cout << "Recording callbacks to " << path << std::endl;
+}
+
+// The journal is closed once the last in flight callback releases it
+void tWrapper::stopRecording() { std::atomic_store(&journal_, std::shared_ptr<JournalWriter>()); }
+bool tWrapper::isRecording() const { return std::atomic_load(&journal_) != nullptr; }
+
+// ======================= tWrapper Tick Streaming =======================
+
+TickBarBuilder& tWrapper::tickBars() { return tickBars_; }
+void tWrapper::flushTickBars() { tickBars_.flush(serverTimeMs()); }
+
+std::vector<std::shared_ptr<Candle>> tWrapper::processedTickBars() {
+    std::vector<std::shared_ptr<Candle>> bars;
+    subBars_.consumeAll([&bars](RealtimeBar&& bar) { bars.push_back(makePooled<Candle>(bar)); });
+    return bars;
 }
 
+size_t tWrapper::droppedTickBars() const { return subBars_.dropped(); }
+
 // ========================= tWrapper Mutators ===========================
 
 void tWrapper::showHistoricalDataOutput() { showHistoricalData_ = true; }
 void tWrapper::hideHistoricalDataOutput() { showHistoricalData_ = false; }
 void tWrapper::showRealTimeDataOutput() { showRealTimeData_ = true; }
 void tWrapper::hideRealTimeDataOutput() { showRealTimeData_ = false; }
-void tWrapper::setBufferCapacity(const int x) { candleBuffer_.setNewBufferCapacity(x); }
+void tWrapper::setEpochDeadline(std::chrono::milliseconds deadline) { candleBuffer_.setEpochDeadline(deadline); }
 
 // ========================= tWrapper Accsessors ============================
 
 int tWrapper::getReqId() { return Req_; }
 long tWrapper::getCurrentTime() { return time_; }
+long long tWrapper::serverTimeMs() const { return nowMs() + clockOffsetMs_; }
 double tWrapper::lastTickPrice() { return tickPriceLast_; }
-int tWrapper::bufferCapacity() { return candleBuffer_.getCapacity(); }
 bool tWrapper::checkBufferFull() { return candleBuffer_.checkBufferFull(); }
+int tWrapper::activeReqs() { return candleBuffer_.wrapperActiveReqs; }
+size_t tWrapper::droppedCandles() const { return candleBuffer_.droppedCandles(); }
 
 std::vector<std::unique_ptr<Candle>> tWrapper::historicCandles() { return std::move(historicCandles_); }
-std::vector<std::unique_ptr<Candle>> tWrapper::processedFiveSecCandles() { return candleBuffer_.processBuffer(); }
+std::vector<std::shared_ptr<Candle>> tWrapper::processedFiveSecCandles() { return candleBuffer_.processBuffer(); }
+void tWrapper::expectBars(TickerId reqId) { candleBuffer_.expectBars(static_cast<int>(reqId)); }
+void tWrapper::forgetBars(TickerId reqId) { candleBuffer_.forgetBars(static_cast<int>(reqId)); }
 
 std::mutex& tWrapper::wrapperMutex() { return wrapperMtx_; }
 std::condition_variable& tWrapper::wrapperConditional() { return cv_; }
+RequestRegistry& tWrapper::requests() { return requests_; }
+ContractRegistry& tWrapper::contracts() { return contracts_; }
 
 
 //=======================================================================
 // This is a buffer to contain candlestick data and send to app when full
 //=======================================================================
 
-CandleBuffer::CandleBuffer(int capacity) : capacity_(capacity), wrapperActiveReqs{ 0 } {
-    bufferTimePassed_ = std::chrono::steady_clock::now();
-}
-
-std::vector<std::unique_ptr<Candle>> CandleBuffer::processBuffer() {
-    std::lock_guard<std::mutex> lock(bufferMutex);
-    std::vector<std::unique_ptr<Candle>> processedData;
+CandleBuffer::CandleBuffer(size_t ringSize, std::chrono::milliseconds epochDeadline) :
+    ring_(ringSize), barrier_(epochDeadline), wrapperActiveReqs{ 0 } {}
 
-    // Ensure that the underlying is inserted first
-    processedData.push_back(std::move(bufferMap.at(1234)));
-    bufferMap.erase(1234);
+bool CandleBuffer::publish(const RealtimeBar& bar) { return ring_.tryPush(bar); }
 
-    for (auto& c : bufferMap) processedData.push_back(std::move(c.second));
-    bufferMap.clear();
-
-    wasDataProcessed_ = true;
-
-    return processedData;
+std::vector<std::shared_ptr<Candle>> CandleBuffer::processBuffer() {
+    drainRing();
+    return barrier_.release();
 }
 
 bool CandleBuffer::checkBufferFull() {
-    std::lock_guard<std::mutex> lock(bufferMutex);
-    auto currentTime = std::chrono::steady_clock::now();
-    auto timePassed = currentTime - bufferTimePassed_;
-    if (timePassed > std::chrono::seconds(60)) checkBufferStatus();
-
-    //return buffer.size() >= capacity_ && bufferReqs.size() >= capacity_;
-    return static_cast<int>(bufferMap.size()) >= capacity_;
+    drainRing();
+    return barrier_.ready();
 }
 
-void CandleBuffer::setNewBufferCapacity(int value) {
-    capacity_ = value;
-    wasDataProcessed_ = false;
+void CandleBuffer::expectBars(int reqId) {
+    barrier_.expect(reqId);
+    wrapperActiveReqs = static_cast<int>(barrier_.expectedReqs());
 }
 
-void CandleBuffer::updateBuffer(std::unique_ptr<Candle> candle) {
-    std::lock_guard<std::mutex> lock(bufferMutex);
-    bufferMap[candle->reqId()] = std::move(candle);
-    // OPTIONSCANNER_DEBUG("Candle added to buffer, current size: {}", bufferMap.size());
+void CandleBuffer::forgetBars(int reqId) {
+    barrier_.forget(reqId);
+    wrapperActiveReqs = static_cast<int>(barrier_.expectedReqs());
 }
 
-int CandleBuffer::getCapacity() { return capacity_; }
+void CandleBuffer::setEpochDeadline(std::chrono::milliseconds deadline) { barrier_.setDeadline(deadline); }
 
-void CandleBuffer::checkBufferStatus() {
-    if (!wasDataProcessed_) {
+void CandleBuffer::updateBuffer(std::shared_ptr<Candle> candle) {
+    barrier_.insert(std::move(candle));
+    wrapperActiveReqs = static_cast<int>(barrier_.expectedReqs());
+}
 
-#ifndef TEST_CONFIG
-        OPTIONSCANNER_WARN("Buffer not processing data. Current buffer size: {}", bufferMap.size());
-#endif // !TEST_CONFIG
-        setNewBufferCapacity(bufferMap.size());
-    }
+size_t CandleBuffer::droppedCandles() const { return ring_.dropped(); }
+
+void CandleBuffer::drainRing() {
+    // Bars are expanded to Candles here, handed to the scanner from the session pool, see MemoryPool.h
+    ring_.consumeAll([this](RealtimeBar&& bar) {
+        updateBuffer(makePooled<Candle>(bar));
+    });
 
-    // Check if active wrapper requests outnumber current capacity
-    if (wrapperActiveReqs > capacity_) {
+    size_t dropped = ring_.dropped();
+    if (dropped > reportedDrops_) {
 
 #ifndef TEST_CONFIG
-        OPTIONSCANNER_WARN("Number of open requests [{}] is greater than current buffer capacity [{}]", wrapperActiveReqs, capacity_);
+        OPTIONSCANNER_WARN("Ingest ring full, {} candles dropped since last check ({} total)", dropped - reportedDrops_, dropped);
 #endif // !TEST_CONFIG
-        setNewBufferCapacity(wrapperActiveReqs);
+        reportedDrops_ = dropped;
     }
-
-    bufferTimePassed_ = std::chrono::steady_clock::now();
-}
\ No newline at end of file
+}
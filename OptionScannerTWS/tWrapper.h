@@ -17,44 +17,59 @@
 #include <unordered_set>
 #include <unordered_map>
 #include <condition_variable>
+#include <atomic>
 
 #ifndef TEST_CONFIG
 #include "../Logger.h"
 #endif // !TEST_CONFIG
 
 #include "Candle.h"
+#include "RealtimeBar.h"
+#include "IngestRing.h"
+#include "EpochBarrier.h"
+#include "RequestRegistry.h"
+#include "ContractRegistry.h"
+#include "CallbackJournal.h"
+#include "TickBarBuilder.h"
 #include "TwsApiL0.h"
 #include "TwsApiDefs.h"
 using namespace TwsApi; // for TwsApiDefs.h
 
 //=======================================================================
 // This is a buffer to contain candlestick data and send to app when full
+// Bars are published by the EReader thread into a lock-free ring and are
+// only moved into the epoch barrier by the processing thread, so the
+// callback path never waits on the scanner
 //=======================================================================
 
 class CandleBuffer {
 public:
-    CandleBuffer(int capacity);
+    CandleBuffer(size_t ringSize = 1024,
+        std::chrono::milliseconds epochDeadline = std::chrono::milliseconds(500));
 
-    std::vector<std::unique_ptr<Candle>> processBuffer();
+    // Producer side, called from the wrapper callbacks
+    bool publish(const RealtimeBar& bar);
+
+    // Consumer side, called from the processing thread only
+    // Returns the oldest released epoch, underlying first
+    std::vector<std::shared_ptr<Candle>> processBuffer();
 
     bool checkBufferFull(void);
-    void setNewBufferCapacity(int value);
-    void updateBuffer(std::unique_ptr<Candle> candle);
-    int getCapacity(void);
+    void expectBars(int reqId);
+    void forgetBars(int reqId);
+    void setEpochDeadline(std::chrono::milliseconds deadline);
+    void updateBuffer(std::shared_ptr<Candle> candle);
+    size_t droppedCandles(void) const;
 
-    int wrapperActiveReqs; // Will ensure buffer capacity is the same as all wrapper open requests
+    int wrapperActiveReqs; // Number of reqIds the barrier is currently waiting on each epoch
 
 private:
-    void checkBufferStatus();
-
-    // bufferMap will ensure we have all reqIds from the request list before emptying the buffer
-    std::unordered_map<int, std::unique_ptr<Candle>> bufferMap;
-    int capacity_;
-    std::chrono::time_point<std::chrono::steady_clock> bufferTimePassed_;
+    void drainRing();
 
-    bool wasDataProcessed_{ false }; // Periodically check to ensure buffer is processing and not in an unfilled state
+    IngestRing<RealtimeBar> ring_;
+    EpochBarrier barrier_;
 
-    std::mutex bufferMutex;
+    size_t reportedDrops_{ 0 };
 };
 
 // We can define our own eWrapper to implement only the functionality that we need to use
@@ -62,7 +77,7 @@ class tWrapper : public EWrapperL0 {
 
 public:
     ///Easier: The EReader calls all methods automatically(optional)
-    tWrapper(int initBufferSize, bool runEReader = true);
+    tWrapper(bool runEReader = true);
 
     // Public variables to determine completion of certain wrapper requests
     bool m_Done, m_ErrorForRequest;
@@ -112,10 +127,35 @@ public:
     virtual void realtimeBar(TickerId reqId, long time, double open, double high,
         double low, double close, long volume, double wap, int count);
 
+    virtual void contractDetails(int reqId, const ContractDetails& contractDetails);
+    virtual void contractDetailsEnd(int reqId);
+
     virtual void cancelRealTimeBars(TickerId tickerId) {
         std::cout << "Cancelled real time bar data for " << tickerId << std::endl;
     }
 
+    //========================================
+    // Recording
+    //========================================
+
+    // Appends every realtimeBar, tickPrice, tickSize, tickString and error callback to a binary journal
+    // Replay it with JournalReplay, see CallbackJournal.h
+    void startRecording(const std::string& path);
+    void stopRecording();
+    bool isRecording() const;
+
+    //========================================
+    // Tick Streaming
+    //========================================
+
+    // Contracts tracked here and requested with reqMktData and generic tick 233 are built into bars
+    // from their RT_VOLUME ticks. Their 5 second bars join the epoch like realtime bars, sub bars
+    // are drained separately. Bars are timed on the server clock, see serverTimeMs
+    TickBarBuilder& tickBars();
+    void flushTickBars();
+    std::vector<std::shared_ptr<Candle>> processedTickBars();
+    size_t droppedTickBars() const;
+
     //========================================
     // Mutators
     //========================================
@@ -124,7 +164,7 @@ public:
     void hideHistoricalDataOutput();
     void showRealTimeDataOutput();
     void hideRealTimeDataOutput();
-    void setBufferCapacity(const int x);
+    void setEpochDeadline(std::chrono::milliseconds deadline);
 
     //=======================================
     // Accessors
@@ -132,19 +172,42 @@ public:
 
     int getReqId();
     long getCurrentTime();
+    // Host clock corrected by the offset measured from the last reqCurrentTime
+    // Tick bars are closed on this clock so they share epoch keys with IB's realtime bars
+    long long serverTimeMs() const;
     double lastTickPrice();
-    int bufferCapacity();
     bool checkBufferFull();
+    int activeReqs();
+    size_t droppedCandles() const;
     std::vector<std::unique_ptr<Candle>> historicCandles();
-    std::vector<std::unique_ptr<Candle>> processedFiveSecCandles();
+    std::vector<std::shared_ptr<Candle>> processedFiveSecCandles();
+
+    // Epochs wait on a contract from its subscription until it is cancelled
+    // Processing thread only, like processedFiveSecCandles
+    void expectBars(TickerId reqId);
+    void forgetBars(TickerId reqId);
 
     std::mutex& wrapperMutex();
     std::condition_variable& wrapperConditional();
 
+    // Futures for snapshot, historical data and contract detail requests by reqId
+    RequestRegistry& requests();
+
+    // Slots for streaming contracts, assign before sending reqRealTimeBars so every bar arrives stamped
+    ContractRegistry& contracts();
+
 private:
     CandleBuffer candleBuffer_;
+    RequestRegistry requests_;
+    ContractRegistry contracts_;
+
+    TickBarBuilder tickBars_;
+    IngestRing<RealtimeBar> subBars_{ 4096 };
 
-    // Mutex and conditional for buffer use
+    // Swapped atomically so recording can start or stop while the EReader is dispatching
+    std::shared_ptr<JournalWriter> journal_;
+
+    // Mutex and conditional for the processing thread to wait on, realtimeBar only notifies
     std::mutex wrapperMtx_;
     std::condition_variable cv_;
 
@@ -156,13 +219,12 @@ private:
     std::vector<std::unique_ptr<Candle>> historicCandles_;
     std::vector<std::unique_ptr<Candle>> fiveSecCandles_;
 
-    std::unordered_set<int> activeReqs_;
-
     // Variables to show data request output
     bool showHistoricalData_{ false };
     bool showRealTimeData_{ false };
 
-    long time_{ 0 };
+    std::atomic<long> time_{ 0 }; // Written by the EReader thread
+    std::atomic<long long> clockOffsetMs_{ 0 }; // Server minus host clock, zero until currentTime arrives
     // Last tick price for requested contract
     double tickPriceLast_{ 0 };
 
@@ -0,0 +1,208 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "ContractData.h"
+#include "MemoryPool.h"
+
+#include <chrono>
+
+using namespace testing;
+
+namespace {
+	constexpr int kBars = 720 * 6; // One hour of 5 second bars for six contracts
+	constexpr int kContracts = 6;
+
+	struct AllocationResult {
+		double callsPerBar; // Allocator calls, heap allocations on the legacy path and pool blocks on the pooled one
+		double heapPerBar;  // Calls that reached the heap
+		double seconds;
+	};
+
+	//=================================================================
+	// Allocations are counted where they are made, so nothing outside
+	// the benchmark is affected. The legacy path goes through a counting
+	// std::allocator and every call is a heap allocation. The pooled
+	// path is counted in blocks handed out by the session pools, and
+	// only reaches the heap when a pool carves a new slab
+	//=================================================================
+
+	template <typename T>
+	struct CountingAllocator {
+		using value_type = T;
+
+		explicit CountingAllocator(size_t* count) noexcept : count(count) {}
+		template <typename U>
+		CountingAllocator(const CountingAllocator<U>& other) noexcept : count(other.count) {}
+
+		T* allocate(size_t n) {
+			(*count)++;
+			return std::allocator<T>().allocate(n);
+		}
+		void deallocate(T* p, size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+		template <typename U>
+		bool operator==(const CountingAllocator<U>& other) const noexcept { return count == other.count; }
+		template <typename U>
+		bool operator!=(const CountingAllocator<U>& other) const noexcept { return count != other.count; }
+
+		size_t* count;
+	};
+
+	size_t pooledSlabs() {
+		size_t slabs = 0;
+		for (size_t bytes = MemoryPool::kSizeClassStep; bytes <= MemoryPool::kMaxPooledSize; bytes += MemoryPool::kSizeClassStep) {
+			slabs += MemoryPool::poolFor(bytes)->slabCount();
+		}
+		return slabs;
+	}
+
+	size_t pooledBlocks() {
+		size_t blocks = 0;
+		for (size_t bytes = MemoryPool::kSizeClassStep; bytes <= MemoryPool::kMaxPooledSize; bytes += MemoryPool::kSizeClassStep) {
+			blocks += MemoryPool::poolFor(bytes)->blocksAllocated();
+		}
+		return blocks;
+	}
+
+	using LegacyBars = std::vector<std::shared_ptr<Candle>, CountingAllocator<std::shared_ptr<Candle>>>;
+
+	// The 5 second bar as the old buffer handed it over, a unique_ptr moved into a shared_ptr
+	std::shared_ptr<Candle> legacyBar(size_t* count, int id, long time, double px) {
+		CountingAllocator<Candle> alloc(count);
+		Candle* raw = alloc.allocate(1);
+		new (raw) Candle(id, time, px, px + 0.1, px - 0.1, px, 150L, px, 3);
+		return std::shared_ptr<Candle>(raw, [count](Candle* c) {
+			c->~Candle();
+			CountingAllocator<Candle>(count).deallocate(c, 1);
+		}, alloc);
+	}
+
+	// The old createNewBars, which took the series by value and returned a make_shared candle
+	std::shared_ptr<Candle> legacyRollUp(size_t* count, int id, int increment, LegacyBars data) {
+		double open = data[data.size() - increment]->open();
+		double close = data[data.size() - 1]->close();
+		long time = data[data.size() - 1]->time();
+
+		double high = 0;
+		double low = INT_MAX;
+		long volume = 0;
+
+		for (size_t i = data.size() - increment; i <= data.size() - 1; i++) {
+			high = max(high, data[i]->high());
+			low = min(low, data[i]->low());
+			volume += data[i]->volume();
+		}
+
+		return std::allocate_shared<Candle>(CountingAllocator<Candle>(count), id, time, open, high, low, close, volume);
+	}
+
+	// Simulates the per bar object traffic of ContractData::updateData
+	// Pooled mirrors the current path, legacy the make_unique / make_shared path it replaced
+	template <bool Pooled>
+	AllocationResult runBars(int bars) {
+		using Clock = std::chrono::high_resolution_clock;
+		using Second = std::chrono::duration<double, std::ratio<1> >;
+
+		size_t legacyCount = 0;
+
+		std::vector<std::vector<std::shared_ptr<Candle>>> fiveSec(kContracts);
+		std::vector<LegacyBars> legacyFiveSec(kContracts, LegacyBars(CountingAllocator<std::shared_ptr<Candle>>(&legacyCount)));
+		std::vector<std::vector<std::shared_ptr<Candle>>> thirtySec(kContracts);
+		for (auto& v : fiveSec) v.reserve(bars);
+		for (auto& v : legacyFiveSec) v.reserve(bars);
+		for (auto& v : thirtySec) v.reserve(bars / 6 + 1);
+
+		std::vector<std::shared_ptr<CandleTags>> alerts;
+		alerts.reserve(bars * 2);
+
+		legacyCount = 0;
+		size_t slabsBefore = pooledSlabs();
+		size_t blocksBefore = pooledBlocks();
+		auto m_beg = Clock::now();
+
+		for (int i = 0; i < bars; i++) {
+			int c = i % kContracts;
+			long time = 1691347530 + 5 * (i / kContracts);
+			double px = 4.0 + (i % 7) * 0.05;
+
+			std::shared_ptr<Candle> bar;
+			if (Pooled) {
+				bar = makePooled<Candle>(4500 + c, time, px, px + 0.1, px - 0.1, px, 150L, px, 3);
+				fiveSec[c].push_back(bar);
+			}
+			else {
+				bar = legacyBar(&legacyCount, 4500 + c, time, px);
+				legacyFiveSec[c].push_back(bar);
+			}
+
+			std::shared_ptr<CandleTags> tags;
+			if (Pooled) {
+				tags = makePooled<CandleTags>(bar, TimeFrame::FiveSecs, Alerts::OptionType::Call, Alerts::TimeOfDay::Hour1,
+					Alerts::VolumeStDev::LowVol, Alerts::VolumeThreshold::Vol100, Alerts::PriceDelta::Under1,
+					Alerts::DailyHighsAndLows::Inside, Alerts::LocalHighsAndLows::Inside);
+			}
+			else {
+				tags = std::allocate_shared<CandleTags>(CountingAllocator<CandleTags>(&legacyCount), bar, TimeFrame::FiveSecs,
+					Alerts::OptionType::Call, Alerts::TimeOfDay::Hour1, Alerts::VolumeStDev::LowVol, Alerts::VolumeThreshold::Vol100,
+					Alerts::PriceDelta::Under1, Alerts::DailyHighsAndLows::Inside, Alerts::LocalHighsAndLows::Inside);
+			}
+			alerts.push_back(tags);
+
+			// 30 second roll up
+			if ((i / kContracts + 1) % 6 == 0) {
+				std::shared_ptr<Candle> thirty;
+				if (Pooled) thirty = createNewBars(4500 + c, 6, fiveSec[c]);
+				else thirty = legacyRollUp(&legacyCount, 4500 + c, 6, legacyFiveSec[c]);
+				thirtySec[c].push_back(thirty);
+			}
+
+			// Alert handler releases its tags once the outcome window passes
+			if (alerts.size() > 360) alerts.erase(alerts.begin(), alerts.begin() + 180);
+		}
+
+		double elapsed = std::chrono::duration_cast<Second>(Clock::now() - m_beg).count();
+		size_t calls = Pooled ? pooledBlocks() - blocksBefore : legacyCount;
+		size_t heap = Pooled ? pooledSlabs() - slabsBefore : legacyCount;
+
+		return { static_cast<double>(calls) / bars, static_cast<double>(heap) / bars, elapsed };
+	}
+}
+
+TEST(BenchmarkTests, candlePoolAllocationsPerBar) {
+	// Both sides run cold, the pooled one pays for every slab it carves during the run
+	AllocationResult pooled = runBars<true>(kBars);
+	AllocationResult legacy = runBars<false>(kBars);
+
+	std::cout << "Allocations per bar      | legacy: " << legacy.callsPerBar << " pooled: " << pooled.callsPerBar << std::endl;
+	std::cout << "Heap allocations per bar | legacy: " << legacy.heapPerBar << " pooled: " << pooled.heapPerBar << std::endl;
+	std::cout << "Elapsed time             | legacy: " << legacy.seconds << "s pooled: " << pooled.seconds << "s" << std::endl;
+
+	// Legacy pays for each bar, its control block and its tags, plus the series copy and candle of each roll up
+	// Pooled shares one block between each object and its control block, and skips the series copy
+	EXPECT_GE(legacy.callsPerBar, 3.0);
+	EXPECT_LT(pooled.callsPerBar, legacy.callsPerBar);
+
+	// A slab holds 1024 blocks, so even a cold run reaches the heap for well under 1% of bars
+	EXPECT_LT(pooled.heapPerBar, 0.01);
+	EXPECT_LT(pooled.heapPerBar * 100, legacy.heapPerBar);
+}
+
+TEST(BenchmarkTests, slabPoolRecyclesBlocks) {
+	SlabPool pool{ sizeof(Candle), 8 };
+
+	std::vector<void*> blocks;
+	for (int i = 0; i < 8; i++) blocks.push_back(pool.allocate());
+	EXPECT_EQ(pool.slabCount(), 1u);
+	EXPECT_EQ(pool.blocksInUse(), 8u);
+
+	void* first = blocks[0];
+	pool.deallocate(first);
+	EXPECT_EQ(pool.allocate(), first);
+
+	blocks.push_back(pool.allocate());
+	EXPECT_EQ(pool.slabCount(), 2u);
+
+	for (void* b : blocks) pool.deallocate(b);
+	EXPECT_EQ(pool.blocksInUse(), 0u);
+}
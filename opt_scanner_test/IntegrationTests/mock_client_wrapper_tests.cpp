@@ -209,4 +209,36 @@ TEST(ClientWrapperTest, realTimeBarsEdgeCase) {
 	EXPECT_EQ(contracts.size(), 2);
 	EXPECT_EQ(contracts.size(), mWrapper.getBufferCapacity());
 	EXPECT_TRUE(contracts[4580].size() > 10);
-}
\ No newline at end of file
+}
+// Replay a recorded session through the mock client in place of random candles
+TEST(ClientWrapperTest, realTimeBarsFromJournal) {
+	const char* path = "mock_client_journal_test.bin";
+	{
+		JournalWriter writer(path);
+		for (int i = 0; i < 20; i++) {
+			writer.appendRealtimeBar(1234, 1691347530 + i * 5, 4500, 4502, 4499, 4500 + i, 1000, 0, 0);
+			writer.appendRealtimeBar(4590, 1691347530 + i * 5, 5, 6, 4, 5, 100, 0, 0);
+			writer.appendRealtimeBar(4600, 1691347530 + i * 5, 1, 2, 1, 1, 10, 0, 0); // Never requested
+		}
+		writer.appendTickPrice(4590, TickType::LAST, 5.1, 0);
+	}
+
+	MockWrapper mWrapper;
+	MockClient mClient(mWrapper);
+	mClient.setJournal(path, 0);
+
+	Contract con;
+	con.symbol = "SPX";
+	con.secType = "OPT";
+
+	mClient.reqRealTimeBars(1234, con, 0, "", true);
+	mClient.reqRealTimeBars(4590, con, 0, "", true);
+
+	mClient.waitForReplay();
+
+	EXPECT_EQ(mWrapper.getActiveReqs(), (std::unordered_set<int>{ 1234, 4590 }));
+	EXPECT_DOUBLE_EQ(mWrapper.getSPXPrice(), 4519);
+	EXPECT_EQ(mWrapper.replayedTicks, 1);
+
+	std::remove(path);
+}
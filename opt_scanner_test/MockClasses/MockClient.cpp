@@ -51,6 +51,11 @@ void MockClient::reqHistoricalData(TickerId id, const Contract& contract,
 void MockClient::reqRealTimeBars(TickerId id, const Contract& contract, int barSize,
     const IBString& whatToShow, bool useRTH) {
 
+    if (journal_) {
+        threads_.emplace_back([this, id]() { streamJournalData(id); });
+        return;
+    }
+
     bool isOption;
     (contract.secType == "OPT") ? isOption = true : isOption = false;
 
@@ -90,6 +95,24 @@ void MockClient::cancelRealTimeBars() {
 
 void MockClient::setCandleInterval(int i) { candleInterval = i; }
 
+void MockClient::setJournal(const std::string& path, double speed) {
+    journal_ = std::make_unique<JournalReader>(path);
+    replaySpeed_ = speed;
+}
+
+void MockClient::waitForReplay() {
+    // Replays end on their own once the journal is exhausted, random streams never would
+    if (!journal_) return;
+
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+
+    threads_.clear();
+}
+
 void MockClient::streamRealTimeData(const TickerId reqId, long unixTime, double refPrice, long refVol, bool isOption) {
     //std::unique_lock<std::mutex> lock(wrapper_.getBufferMutex());
 
@@ -105,6 +128,12 @@ void MockClient::streamRealTimeData(const TickerId reqId, long unixTime, double
     //std::cout << "Stream thread " << reqId << " is terminating..." << std::endl;
 }
 
+void MockClient::streamJournalData(const TickerId reqId) {
+    // Each request replays only its own records, so pacing matches the recorded session
+    JournalReplay replay(*journal_, replaySpeed_);
+    replay.run(wrapper_, [reqId](const JournalRecord& r) { return r.reqId == reqId; }, &terminateStream);
+}
+
 //======================================================
 // Helper Functions
 //======================================================
@@ -8,6 +8,7 @@
 #include <atomic>
 
 #include "MockWrapper.h"
+#include "CallbackJournal.h"
 
 // For use in random candle generation
 struct MiniCandle {
@@ -40,13 +41,22 @@ public:
 
 	void setCandleInterval(int i); // In miliseconds
 
+	// Stream a recorded session instead of random candles, speed as in JournalReplay
+	void setJournal(const std::string& path, double speed = 1.0);
+	// Blocks until every journal replay has dispatched all of its records
+	void waitForReplay();
+
 	// Mock RTB stream
 	void streamRealTimeData(const TickerId reqId, long unixTime, double refPrice, long refVol, bool isOption);
+	void streamJournalData(const TickerId reqId);
 
 private:
 	MockWrapper& wrapper_;
 
-	bool terminateStream = false;
+	std::atomic<bool> terminateStream{ false };
+
+	std::unique_ptr<JournalReader> journal_;
+	double replaySpeed_ = 1.0;
 
 	std::vector<std::thread> threads_;
 	std::condition_variable cv_;
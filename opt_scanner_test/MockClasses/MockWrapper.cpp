@@ -170,6 +170,11 @@ void MockWrapper::realtimeBar(TickerId reqId, long time, double open, double hig
     cv.notify_one();
 }
 
+void MockWrapper::tickPrice(TickerId tickerId, TickType field, double price, int canAutoExecute) { replayedTicks++; }
+void MockWrapper::tickSize(TickerId tickerId, TickType field, int size) { replayedTicks++; }
+void MockWrapper::tickString(TickerId tickerId, TickType tickType, const IBString& value) { replayedTicks++; }
+void MockWrapper::error(const int id, const int errorCode, const IBString errorString) { replayedErrors++; }
+
 std::vector<Candle> MockWrapper::getCopiedCandleVector() { return copiedCandleVector; }
 std::queue<Candle> MockWrapper::getCopiedCandleQueue() { return copiedCandleQueue; }
 std::queue<std::unique_ptr<Candle>> MockWrapper::getMovedCandleQueue() { return std::move(movedCandleQueue); }
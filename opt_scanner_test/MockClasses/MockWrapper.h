@@ -12,6 +12,7 @@
 #include <unordered_map>
 #include <queue>
 #include <condition_variable>
+#include <atomic>
 
 ///Easier: Just one include statement for all functionality
 #include "TwsApiL0.h"
@@ -90,6 +91,15 @@ public:
     virtual void realtimeBar(TickerId reqId, long time, double open, double high,
         double low, double close, long volume, double wap, int count);
 
+    // Only counted, these arrive when a recorded journal is replayed
+    virtual void tickPrice(TickerId tickerId, TickType field, double price, int canAutoExecute);
+    virtual void tickSize(TickerId tickerId, TickType field, int size);
+    virtual void tickString(TickerId tickerId, TickType tickType, const IBString& value);
+    virtual void error(const int id, const int errorCode, const IBString errorString);
+
+    std::atomic<int> replayedTicks{ 0 };
+    std::atomic<int> replayedErrors{ 0 };
+
     // Variables for other tests
     int candleBenchmarkSwitch = 1; // 1 - smtptr vector, 2 - smtptr queue, 3 - copied vector, 4 - copied queue
 
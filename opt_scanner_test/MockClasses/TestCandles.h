@@ -0,0 +1,33 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+//=======================================================================
+// Candles for the unit tests
+// Bar i is the i'th 5 second bar after the 8:30 CDT open on 2023-08-07
+//=======================================================================
+
+#pragma once
+
+#include <memory>
+
+#include "Candle.h"
+
+namespace TestCandles {
+	const long kOpen = 1691415000;
+
+	inline long barTime(int i) { return kOpen + i * 5; }
+
+	inline std::shared_ptr<Candle> bar(TickerId req, int i, double open, double high, double low, double close, long volume) {
+		return std::make_shared<Candle>(req, barTime(i), open, high, low, close, volume);
+	}
+
+	// Bar i of a series that moves through a few prices with a varying range and rising volume
+	inline std::shared_ptr<Candle> variedBar(TickerId req, int i) {
+		double base = 2.0 + (i % 9) * 0.05;
+		return bar(req, i, base, base + 0.1 + (i % 4) * 0.02, base - 0.05 - (i % 3) * 0.01, base + 0.02, 10L + i);
+	}
+
+	// Single price bar at any time, owned the way the wrapper hands bars to the epoch barrier
+	inline std::unique_ptr<Candle> flatBar(TickerId req, long time, double price = 1.0) {
+		return std::make_unique<Candle>(req, time, price, price, price, price, 100, price, 1);
+	}
+}
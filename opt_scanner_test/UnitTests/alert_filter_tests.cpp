@@ -0,0 +1,67 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "ContractData.h"
+#include "OptionScanner.h"
+#include "../MockClasses/TestCandles.h"
+
+namespace {
+    std::shared_ptr<Candle> fiveSecBar(int i, long volume) { return TestCandles::bar(4500, i, 2.0, 2.1, 1.9, 2.05, volume); }
+}
+
+TEST(AlertFilterTest, rejectedBarsBuildNoTags) {
+    ContractData cd(4500);
+    int candidates = 0;
+    int alerts = 0;
+
+    cd.registerAlertFilter([&candidates](const AlertCandidate& c) {
+        candidates++;
+        return c.tf == TimeFrame::OneMin;
+    });
+    cd.registerAlert([&alerts](std::shared_ptr<CandleTags> tags) {
+        EXPECT_EQ(tags->getTimeFrame(), TimeFrame::OneMin);
+        alerts++;
+    });
+
+    // 5 minutes of heavy 5 second bars, each one a candidate
+    for (int i = 0; i < 60; i++) cd.updateData(fiveSecBar(i, 150));
+
+    EXPECT_EQ(candidates, 60 + 10 + 5 + 1);
+    EXPECT_EQ(alerts, 5);
+}
+
+TEST(AlertFilterTest, candidateCarriesPlainStats) {
+    ContractData cd(4501);
+    std::vector<AlertCandidate> seen;
+    cd.registerAlertFilter([&seen](const AlertCandidate& c) { seen.push_back(c); return false; });
+    cd.registerAlert([](std::shared_ptr<CandleTags>) { FAIL() << "Filter rejected every bar"; });
+
+    for (int i = 0; i < 6; i++) cd.updateData(fiveSecBar(i, 200));
+
+    ASSERT_EQ(seen.size(), 7);
+    EXPECT_EQ(seen[0].reqId, 4501);
+    EXPECT_EQ(seen[0].volume, 200);
+    EXPECT_DOUBLE_EQ(seen[0].close, 2.05);
+    EXPECT_EQ(seen[0].volStDev, 0);
+    EXPECT_EQ(seen.back().tf, TimeFrame::ThirtySecs);
+    EXPECT_EQ(seen.back().volume, 1200);
+}
+
+TEST(AlertFilterTest, gateNeedsScopePriceAndVolume) {
+    AlertGate gate;
+    AlertCandidate c{ 4500, TimeFrame::OneMin, TestCandles::kOpen, 1.5, 150, 0 };
+
+    EXPECT_TRUE(gate.passes(c, true));
+    EXPECT_FALSE(gate.passes(c, false));
+
+    c.close = 0.05;
+    EXPECT_FALSE(gate.passes(c, true));
+
+    c.close = 1.5;
+    c.volume = 20;
+    EXPECT_FALSE(gate.passes(c, true));
+
+    c.volStDev = 2.5;
+    EXPECT_TRUE(gate.passes(c, true));
+}
@@ -0,0 +1,82 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "BarAccumulator.h"
+#include "ContractData.h"
+#include "../MockClasses/TestCandles.h"
+
+TEST(BarAccumulatorTest, foldsBarsAndSeals) {
+    BarAccumulator acc;
+    std::vector<std::shared_ptr<Candle>> bars;
+    for (int i = 0; i < 6; i++) {
+        bars.push_back(TestCandles::variedBar(4500, i));
+        bars.back()->setSlot(3);
+        acc.add(*bars.back());
+    }
+
+    std::shared_ptr<Candle> expected = createNewBars(4500, 6, bars);
+    EXPECT_EQ(acc.count(), 6);
+    EXPECT_EQ(acc.slot(), 3);
+
+    BarSummary sealed = acc.seal();
+    EXPECT_EQ(sealed.time, expected->time());
+    EXPECT_DOUBLE_EQ(sealed.open, expected->open());
+    EXPECT_DOUBLE_EQ(sealed.high, expected->high());
+    EXPECT_DOUBLE_EQ(sealed.low, expected->low());
+    EXPECT_DOUBLE_EQ(sealed.close, expected->close());
+    EXPECT_EQ(sealed.volume, expected->volume());
+
+    EXPECT_TRUE(acc.empty());
+    acc.add(*bars[2]);
+    EXPECT_DOUBLE_EQ(acc.bar().open, bars[2]->open());
+    EXPECT_EQ(acc.bar().volume, bars[2]->volume());
+}
+
+TEST(BarAccumulatorTest, contractSealsOnEachBoundary) {
+    ContractData cd(4500);
+    std::vector<std::shared_ptr<Candle>> bars;
+
+    for (int i = 0; i < 150; i++) {
+        bars.push_back(TestCandles::variedBar(4500, i));
+        cd.updateData(bars.back());
+    }
+
+    EXPECT_EQ(cd.thirtySecData().size(), 25);
+    EXPECT_EQ(cd.oneMinData().size(), 12);
+    EXPECT_EQ(cd.fiveMinData().size(), 2);
+
+    // The second 5 minute bar covers 5 second bars 60 to 119
+    std::vector<std::shared_ptr<Candle>> window(bars.begin() + 60, bars.begin() + 120);
+    std::shared_ptr<Candle> expected = createNewBars(4500, 60, window);
+    std::shared_ptr<Candle> fiveMin = cd.fiveMinData().back();
+    EXPECT_EQ(fiveMin->time(), expected->time());
+    EXPECT_DOUBLE_EQ(fiveMin->high(), expected->high());
+    EXPECT_DOUBLE_EQ(fiveMin->low(), expected->low());
+    EXPECT_EQ(fiveMin->volume(), expected->volume());
+}
+
+TEST(BarAccumulatorTest, partialBarShowsBarSoFar) {
+    ContractData cd(4500);
+    EXPECT_EQ(cd.partialBar(TimeFrame::FiveMin), nullptr);
+
+    std::vector<std::shared_ptr<Candle>> bars;
+    for (int i = 0; i < 75; i++) {
+        bars.push_back(TestCandles::variedBar(4500, i));
+        cd.updateData(bars.back());
+    }
+
+    // 15 bars into the second 5 minute bar, 3 into the current 30 second bar
+    std::vector<std::shared_ptr<Candle>> window(bars.begin() + 60, bars.end());
+    std::shared_ptr<Candle> expected = createNewBars(4500, 15, window);
+    std::shared_ptr<Candle> partial = cd.partialBar(TimeFrame::FiveMin);
+    ASSERT_NE(partial, nullptr);
+    EXPECT_DOUBLE_EQ(partial->open(), expected->open());
+    EXPECT_DOUBLE_EQ(partial->high(), expected->high());
+    EXPECT_EQ(partial->volume(), expected->volume());
+    EXPECT_EQ(partial->time(), bars.back()->time());
+
+    EXPECT_DOUBLE_EQ(cd.partialBar(TimeFrame::ThirtySecs)->open(), bars[72]->open());
+    EXPECT_EQ(cd.partialBar(TimeFrame::OneMin)->volume(), bars[72]->volume() + bars[73]->volume() + bars[74]->volume());
+    EXPECT_EQ(cd.partialBar(TimeFrame::FiveSecs), bars.back());
+}
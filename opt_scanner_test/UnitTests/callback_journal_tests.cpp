@@ -0,0 +1,156 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <cstdio>
+#include <vector>
+
+#include "CallbackJournal.h"
+
+namespace {
+    const char* kJournalPath = "callback_journal_test.bin";
+
+    // Captures replayed callbacks in order
+    struct RecordingWrapper {
+        std::vector<TickerId> bars;
+        std::vector<double> closes;
+        std::vector<double> prices;
+        std::vector<int> sizes;
+        std::vector<std::string> strings;
+        std::vector<int> errors;
+
+        void realtimeBar(TickerId reqId, long time, double open, double high,
+            double low, double close, long volume, double wap, int count) {
+            bars.push_back(reqId);
+            closes.push_back(close);
+        }
+        void tickPrice(TickerId tickerId, TickType field, double price, int canAutoExecute) { prices.push_back(price); }
+        void tickSize(TickerId tickerId, TickType field, int size) { sizes.push_back(size); }
+        void tickString(TickerId tickerId, TickType tickType, const IBString& value) { strings.push_back(std::string(value)); }
+        void error(const int id, const int errorCode, const IBString errorString) { errors.push_back(errorCode); }
+    };
+}
+
+TEST(CallbackJournalTest, roundTrip) {
+    {
+        JournalWriter writer(kJournalPath);
+        writer.appendRealtimeBar(1234, 1691347530, 4500, 4502, 4499, 4501.5, 120, 4500.7, 14);
+        writer.appendTickPrice(111, TickType::LAST, 4501.25, 0);
+        writer.appendTickSize(111, TickType::LAST_SIZE, 3);
+        writer.appendError(5, 200, "No security definition has been found for the request, check the strike and expiry");
+        EXPECT_EQ(writer.count(), 4);
+    }
+
+    JournalReader reader(kJournalPath);
+    ASSERT_EQ(reader.size(), 4);
+
+    EXPECT_EQ(reader[0].type, JournalRecordType::RealtimeBar);
+    EXPECT_EQ(reader[0].reqId, 1234);
+    EXPECT_EQ(reader[0].payload.bar.time, 1691347530);
+    EXPECT_DOUBLE_EQ(reader[0].payload.bar.close, 4501.5);
+    EXPECT_EQ(reader[0].payload.bar.volume, 120);
+
+    EXPECT_EQ(reader[1].type, JournalRecordType::TickPrice);
+    EXPECT_DOUBLE_EQ(reader[1].payload.tick.price, 4501.25);
+    EXPECT_EQ(reader[2].payload.size.size, 3);
+
+    EXPECT_EQ(reader[3].payload.error.code, 200);
+    EXPECT_STREQ(reader[3].payload.error.message, "No security definition has been found for the request, chec");
+
+    // Receive timestamps never go backwards
+    for (size_t i = 1; i < reader.size(); i++) EXPECT_GE(reader[i].recvNs, reader[i - 1].recvNs);
+
+    std::remove(kJournalPath);
+}
+
+TEST(CallbackJournalTest, growsPastFirstChunk) {
+    {
+        JournalWriter writer(kJournalPath, 4);
+        for (int i = 0; i < 10; i++) writer.appendRealtimeBar(i, 1691347530 + i * 5, 1, 2, 0.5, i, 100, 1, 1);
+    }
+
+    JournalReader reader(kJournalPath);
+    ASSERT_EQ(reader.size(), 10);
+    for (int i = 0; i < 10; i++) EXPECT_DOUBLE_EQ(reader[i].payload.bar.close, i);
+
+    std::remove(kJournalPath);
+}
+
+TEST(CallbackJournalTest, replayDispatchesInOrder) {
+    {
+        JournalWriter writer(kJournalPath);
+        writer.appendRealtimeBar(1234, 1691347530, 4500, 4502, 4499, 4501, 120, 0, 0);
+        writer.appendTickPrice(111, TickType::LAST, 4501.25, 0);
+        writer.appendRealtimeBar(5000, 1691347530, 5, 6, 4, 5.5, 20, 0, 0);
+        writer.appendTickSize(111, TickType::LAST_SIZE, 7);
+        writer.appendTickString(4500, TickType::RT_VOLUME, "5.10;3;1691418600123;1234;5.05;true");
+        writer.appendError(5000, 354, "Not subscribed");
+    }
+
+    JournalReader reader(kJournalPath);
+    JournalReplay replay(reader, 0);
+
+    RecordingWrapper all;
+    EXPECT_EQ(replay.run(all), 6);
+    EXPECT_EQ(all.bars, (std::vector<TickerId>{ 1234, 5000 }));
+    EXPECT_EQ(all.prices.size(), 1);
+    EXPECT_EQ(all.sizes, std::vector<int>{ 7 });
+    EXPECT_EQ(all.strings, std::vector<std::string>{ "5.10;3;1691418600123;1234;5.05;true" });
+    EXPECT_EQ(all.errors, std::vector<int>{ 354 });
+
+    // Filtered replay only sees one request
+    RecordingWrapper one;
+    EXPECT_EQ(replay.run(one, [](const JournalRecord& r) { return r.reqId == 5000; }), 2);
+    EXPECT_EQ(one.closes, std::vector<double>{ 5.5 });
+    EXPECT_EQ(one.errors.size(), 1);
+
+    std::remove(kJournalPath);
+}
+
+TEST(CallbackJournalTest, replayKeepsRecordedPace) {
+    {
+        JournalWriter writer(kJournalPath);
+        writer.appendRealtimeBar(1234, 1691347530, 1, 1, 1, 1, 1, 0, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        writer.appendRealtimeBar(1234, 1691347535, 1, 1, 1, 1, 1, 0, 0);
+    }
+
+    JournalReader reader(kJournalPath);
+    RecordingWrapper w;
+
+    auto start = std::chrono::steady_clock::now();
+    JournalReplay(reader, 1.0).run(w);
+    auto realtime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    JournalReplay(reader, 10.0).run(w);
+    auto fast = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(realtime, std::chrono::milliseconds(95));
+    EXPECT_LT(fast, realtime);
+    EXPECT_EQ(w.bars.size(), 4);
+
+    std::remove(kJournalPath);
+}
+
+TEST(CallbackJournalTest, rejectsForeignFiles) {
+    FILE* f = std::fopen(kJournalPath, "wb");
+    std::vector<char> junk(256, 'x');
+    std::fwrite(junk.data(), 1, junk.size(), f);
+    std::fclose(f);
+
+    EXPECT_THROW(JournalReader reader(kJournalPath), std::runtime_error);
+
+    std::remove(kJournalPath);
+}
+
+TEST(CallbackJournalTest, tooSmallJournalReleasesTheFile) {
+    FILE* f = std::fopen(kJournalPath, "wb");
+    std::fputc('x', f);
+    std::fclose(f);
+
+    EXPECT_THROW(JournalReader reader(kJournalPath), std::runtime_error);
+
+    // Windows refuses to delete a file that still has an open handle
+    EXPECT_EQ(std::remove(kJournalPath), 0);
+}
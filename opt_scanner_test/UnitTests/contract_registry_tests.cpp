@@ -0,0 +1,76 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <stdexcept>
+#include <thread>
+
+#include "ContractRegistry.h"
+#include "ContractData.h"
+
+TEST(ContractRegistryTest, underlyingHoldsFirstSlot) {
+    ContractRegistry registry;
+    EXPECT_EQ(registry.slotOf(1234), ContractRegistry::kUnderlyingSlot);
+    EXPECT_EQ(registry.reqIdOf(ContractRegistry::kUnderlyingSlot), 1234);
+    EXPECT_EQ(registry.size(), 1);
+    EXPECT_EQ(registry.underlying(), nullptr);
+}
+
+TEST(ContractRegistryTest, slotsAreDenseAndStable) {
+    ContractRegistry registry;
+    int call = registry.assign(4500);
+    int put = registry.assign(4501);
+
+    EXPECT_EQ(call, 1);
+    EXPECT_EQ(put, 2);
+    EXPECT_EQ(registry.assign(4500), call);
+    EXPECT_EQ(registry.size(), 3);
+
+    EXPECT_TRUE(registry.contains(4501));
+    EXPECT_FALSE(registry.contains(4505));
+    EXPECT_EQ(registry.slotOf(4505), ContractRegistry::kNoSlot);
+    EXPECT_EQ(registry.slotOf(-1), ContractRegistry::kNoSlot);
+}
+
+TEST(ContractRegistryTest, attachedContractsAreReachableBySlot) {
+    ContractRegistry registry;
+    int slot = registry.assign(4500);
+
+    ContractData* cd = registry.attach(slot, std::make_shared<ContractData>(4500));
+    ContractData* spx = registry.attach(ContractRegistry::kUnderlyingSlot, std::make_shared<ContractData>(1234));
+
+    EXPECT_EQ(registry.at(slot), cd);
+    EXPECT_EQ(registry.underlying(), spx);
+    EXPECT_EQ(registry.at(slot)->contractId(), 4500);
+
+    std::vector<TickerId> visited;
+    registry.forEach([&visited](TickerId req, ContractData& c) { visited.push_back(c.contractId()); });
+    EXPECT_EQ(visited, (std::vector<TickerId>{ 1234, 4500 }));
+}
+
+TEST(ContractRegistryTest, rejectsOutOfRangeAndOverflow) {
+    ContractRegistry registry(1234, 3, 10000);
+    EXPECT_THROW(registry.assign(20000), std::out_of_range);
+    EXPECT_THROW(registry.attach(5, std::make_shared<ContractData>(4500)), std::out_of_range);
+
+    registry.assign(4500);
+    registry.assign(4501);
+    EXPECT_THROW(registry.assign(4505), std::out_of_range);
+}
+
+// Candles keep their slot through the copies made for tags and higher timeframes
+TEST(ContractRegistryTest, slotTravelsWithCandles) {
+    std::vector<std::shared_ptr<Candle>> bars;
+    for (int i = 0; i < 6; i++) {
+        auto c = std::make_shared<Candle>(4500, 1691347530 + i * 5, 1.0, 2.0, 0.5, 1.5, 100L, 0.0, 0);
+        c->setSlot(7);
+        bars.push_back(c);
+    }
+
+    std::shared_ptr<Candle> thirty = createNewBars(4500, 6, bars);
+    EXPECT_EQ(thirty->slot(), 7);
+
+    Candle copy(*thirty);
+    EXPECT_EQ(copy.slot(), 7);
+    EXPECT_EQ(Candle().slot(), ContractRegistry::kNoSlot);
+}
@@ -0,0 +1,156 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "EpochBarrier.h"
+#include "../MockClasses/TestCandles.h"
+
+using TestCandles::flatBar;
+
+class EpochBarrierTest : public ::testing::Test {
+protected:
+    EpochBarrier barrier{ std::chrono::milliseconds(500) };
+    EpochBarrier::Clock::time_point t0 = EpochBarrier::Clock::now();
+
+    // Subscribe the given reqs and fill one epoch for them
+    void prime(const std::vector<int>& reqs, long time) {
+        for (int r : reqs) barrier.expect(r);
+        for (int r : reqs) barrier.insert(flatBar(r, time), t0);
+        barrier.release();
+    }
+};
+
+TEST_F(EpochBarrierTest, releasesWhenAllExpectedArrive) {
+    prime({ 1234, 4500, 4501 }, 100);
+
+    barrier.insert(flatBar(4500, 105), t0);
+    barrier.insert(flatBar(1234, 105), t0);
+    EXPECT_FALSE(barrier.ready(t0));
+
+    barrier.insert(flatBar(4501, 105), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+
+    auto snapshot = barrier.release();
+    ASSERT_EQ(snapshot.size(), 3);
+    EXPECT_EQ(snapshot[0]->reqId(), 1234); // Underlying always first
+    EXPECT_EQ(snapshot[1]->reqId(), 4500);
+    EXPECT_EQ(snapshot[2]->reqId(), 4501);
+    EXPECT_EQ(barrier.lastReleasedTime(), 105);
+}
+
+TEST_F(EpochBarrierTest, deadlineReleasesIncompleteEpoch) {
+    prime({ 1234, 4500, 4501 }, 100);
+
+    barrier.insert(flatBar(1234, 105), t0);
+    barrier.insert(flatBar(4500, 105), t0);
+
+    EXPECT_FALSE(barrier.ready(t0 + std::chrono::milliseconds(499)));
+    EXPECT_TRUE(barrier.ready(t0 + std::chrono::milliseconds(500)));
+    EXPECT_EQ(barrier.release().size(), 2);
+}
+
+TEST_F(EpochBarrierTest, laterEpochsQueueSeparately) {
+    prime({ 1234, 4500 }, 100);
+
+    // A fast contract reports two epochs before the underlying reports once
+    barrier.insert(flatBar(4500, 105, 1.0), t0);
+    barrier.insert(flatBar(4500, 110, 2.0), t0);
+    EXPECT_EQ(barrier.pendingEpochs(), 2);
+
+    barrier.insert(flatBar(1234, 105), t0);
+    ASSERT_TRUE(barrier.ready(t0));
+    auto first = barrier.release();
+    ASSERT_EQ(first.size(), 2);
+    EXPECT_DOUBLE_EQ(first[1]->close(), 1.0);
+
+    barrier.insert(flatBar(1234, 110), t0);
+    auto second = barrier.release();
+    ASSERT_EQ(second.size(), 2);
+    EXPECT_DOUBLE_EQ(second[1]->close(), 2.0);
+}
+
+TEST_F(EpochBarrierTest, newerCompleteEpochReleasesOlder) {
+    prime({ 1234, 4500 }, 100);
+
+    barrier.insert(flatBar(1234, 105), t0);
+    EXPECT_FALSE(barrier.ready(t0));
+
+    // 4500 skipped epoch 105 entirely, once 110 is full there is nothing left to wait for
+    barrier.insert(flatBar(1234, 110), t0);
+    barrier.insert(flatBar(4500, 110), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+    EXPECT_EQ(barrier.release().size(), 1);
+    EXPECT_EQ(barrier.release().size(), 2);
+}
+
+TEST_F(EpochBarrierTest, lateBarsCarryIntoNextSnapshot) {
+    prime({ 1234, 4500 }, 100);
+
+    barrier.insert(flatBar(1234, 105), t0);
+    barrier.release();
+
+    barrier.insert(flatBar(4500, 105), t0); // Late for 105
+    EXPECT_EQ(barrier.lateCandles(), 1);
+
+    barrier.insert(flatBar(1234, 110), t0);
+    barrier.insert(flatBar(4500, 110), t0);
+    auto snapshot = barrier.release();
+    ASSERT_EQ(snapshot.size(), 3);
+    EXPECT_EQ(snapshot[0]->reqId(), 1234);
+    EXPECT_EQ(snapshot[1]->time(), 105);
+    EXPECT_EQ(snapshot[2]->time(), 110);
+}
+
+TEST_F(EpochBarrierTest, quietReqsStopBlockingEpochs) {
+    prime({ 1234, 4500 }, 100);
+
+    long time = 105;
+    for (int i = 0; i < 3; i++, time += 5) {
+        barrier.insert(flatBar(1234, time), t0);
+        barrier.release();
+    }
+
+    EXPECT_EQ(barrier.expectedReqs(), 1);
+    barrier.insert(flatBar(1234, time), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+}
+
+TEST_F(EpochBarrierTest, waitsOnSubscriptionsBeforeTheirFirstBar) {
+    barrier.expect(1234);
+    barrier.expect(4500);
+    barrier.expect(4501);
+
+    // The very first epoch is not complete on the underlying alone
+    barrier.insert(flatBar(1234, 100), t0);
+    barrier.insert(flatBar(4500, 100), t0);
+    EXPECT_FALSE(barrier.ready(t0));
+
+    barrier.insert(flatBar(4501, 100), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+    EXPECT_EQ(barrier.release().size(), 3);
+
+    // A contract subscribed mid session holds up the next epoch as well
+    barrier.expect(4505);
+    for (int r : { 1234, 4500, 4501 }) barrier.insert(flatBar(r, 105), t0);
+    EXPECT_FALSE(barrier.ready(t0));
+    EXPECT_EQ(barrier.lateCandles(), 0);
+
+    barrier.insert(flatBar(4505, 105), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+    EXPECT_EQ(barrier.release().size(), 4);
+}
+
+TEST_F(EpochBarrierTest, forgottenReqsAreNotWaitedOn) {
+    prime({ 1234, 4500 }, 100);
+    barrier.forget(4500);
+    EXPECT_EQ(barrier.expectedReqs(), 1);
+
+    // A bar still in flight after the cancel is released but doesn't rejoin
+    barrier.insert(flatBar(4500, 105), t0);
+    barrier.insert(flatBar(1234, 105), t0);
+    EXPECT_EQ(barrier.release().size(), 2);
+    EXPECT_EQ(barrier.expectedReqs(), 1);
+
+    barrier.insert(flatBar(1234, 110), t0);
+    EXPECT_TRUE(barrier.ready(t0));
+}
@@ -0,0 +1,115 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <random>
+
+#include "ContractData.h"
+#include "EpochEvaluator.h"
+#include "OptionScanner.h"
+#include "../MockClasses/TestCandles.h"
+
+using TestCandles::bar;
+
+TEST(EpochEvaluatorTest, matchesContractDataOnItsOwn) {
+    // Two contracts see the same bars, one works out its own 5 second tags and gate, the other adopts the kernel's
+    ContractData self(4500);
+    ContractData adopted(4500);
+    EpochEvaluator evaluator;
+    AlertGate gate;
+
+    std::vector<std::shared_ptr<CandleTags>> selfAlerts;
+    std::vector<std::shared_ptr<CandleTags>> adoptedAlerts;
+    self.registerAlertFilter([&gate](const AlertCandidate& c) { return gate.passes(c, true); });
+    self.registerAlert([&selfAlerts](std::shared_ptr<CandleTags> t) { selfAlerts.push_back(t); });
+    adopted.registerAlertFilter([&gate](const AlertCandidate& c) { return gate.passes(c, true); });
+    adopted.registerAlert([&adoptedAlerts](std::shared_ptr<CandleTags> t) { adoptedAlerts.push_back(t); });
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> price(1.0, 3.0);
+    std::uniform_real_distribution<double> width(0.0, 0.4);
+    std::lognormal_distribution<double> volume(3.5, 1.2);
+
+    for (int i = 0; i < 900; i++) {
+        double low = price(rng);
+        double high = low + width(rng);
+        long vol = static_cast<long>(volume(rng));
+
+        evaluator.beginEpoch();
+        size_t lane = evaluator.addLane(3, high, high - low, vol, true);
+        evaluator.evaluate();
+
+        self.updateData(bar(4500, i, low, high, low, high, vol));
+        adopted.updateData(bar(4500, i, low, high, low, high, vol), evaluator.verdict(lane));
+
+        ASSERT_EQ(adopted.priceDelta(TimeFrame::FiveSecs), self.priceDelta(TimeFrame::FiveSecs)) << i;
+        ASSERT_EQ(adopted.volStDev(TimeFrame::FiveSecs).mean(), self.volStDev(TimeFrame::FiveSecs).mean()) << i;
+        ASSERT_EQ(adopted.volStDev(TimeFrame::FiveSecs).stDev(), self.volStDev(TimeFrame::FiveSecs).stDev()) << i;
+        ASSERT_EQ(adopted.priceStDev(TimeFrame::FiveSecs).stDev(), self.priceStDev(TimeFrame::FiveSecs).stDev()) << i;
+    }
+
+    ASSERT_EQ(adoptedAlerts.size(), selfAlerts.size());
+    ASSERT_GT(selfAlerts.size(), 0u);
+    for (size_t i = 0; i < selfAlerts.size(); i++) {
+        EXPECT_EQ(adoptedAlerts[i]->tagWord(), selfAlerts[i]->tagWord());
+        EXPECT_EQ(adoptedAlerts[i]->candle.time(), selfAlerts[i]->candle.time());
+    }
+}
+
+TEST(EpochEvaluatorTest, gateNeedsScopePriceAndVolume) {
+    EpochEvaluator evaluator(1);
+
+    evaluator.beginEpoch();
+    for (int slot = 0; slot < 5; slot++) {
+        bool inScope = slot != 1;
+        double close = slot == 2 ? 0.05 : 1.5;
+        long volume = slot == 3 ? 100 : slot == 4 ? 2000 : 150; // The 5 second bar needs more than 100
+        evaluator.addLane(slot, close, 0.1, volume, inScope);
+    }
+    evaluator.evaluate();
+
+    std::vector<bool> passed;
+    for (size_t lane = 0; lane < evaluator.lanes(); lane++) passed.push_back(evaluator.verdict(lane).candidate);
+    EXPECT_EQ(passed, std::vector<bool>({ true, false, false, false, true }));
+    EXPECT_EQ(evaluator.verdict(4).volThresh, Alerts::VolumeThreshold::Vol1000);
+    EXPECT_EQ(evaluator.verdict(3).volThresh, Alerts::VolumeThreshold::Vol100);
+}
+
+TEST(EpochEvaluatorTest, lateBarsAreCountedFirst) {
+    EpochEvaluator evaluator(1);
+
+    // A bar carried in late shares the epoch with the contract's current bar
+    evaluator.beginEpoch();
+    size_t late = evaluator.addLane(5, 2.0, 0.1, 10, true);
+    size_t other = evaluator.addLane(6, 2.0, 0.1, 40, true);
+    size_t current = evaluator.addLane(5, 2.0, 0.3, 30, true);
+    evaluator.evaluate();
+
+    EXPECT_EQ(evaluator.verdict(late).volume.n, 1);
+    EXPECT_EQ(evaluator.verdict(current).volume.n, 2);
+    EXPECT_DOUBLE_EQ(evaluator.verdict(current).volume.mean, 20);
+    EXPECT_DOUBLE_EQ(evaluator.verdict(current).range.mean, 0.2);
+    EXPECT_EQ(evaluator.verdict(other).volume.n, 1);
+
+    // Next epoch carries on from the latest bar
+    evaluator.beginEpoch();
+    size_t next = evaluator.addLane(5, 2.0, 0.2, 20, true);
+    evaluator.evaluate();
+    EXPECT_EQ(evaluator.verdict(next).volume.n, 3);
+    EXPECT_DOUBLE_EQ(evaluator.verdict(next).volume.mean, 20);
+    EXPECT_EQ(evaluator.verdict(next).volStDevs, 0);
+}
+
+TEST(EpochEvaluatorTest, onlySessionContractsAdoptVerdicts) {
+    // A contract on a window baseline keeps its own 5 second moments, the evaluator never sees it
+    ContractData windowed(4500);
+    windowed.setStatsBaseline(TimeFrame::FiveSecs, StatsBaseline::lastN(12));
+
+    EpochEvaluator evaluator;
+    evaluator.beginEpoch();
+    size_t lane = evaluator.addLane(3, 1.5, 0.1, 150, true);
+    evaluator.evaluate();
+
+    EXPECT_THROW(windowed.updateData(bar(4500, 0, 1.4, 1.5, 1.4, 1.5, 150), evaluator.verdict(lane)), std::logic_error);
+    EXPECT_NO_THROW(windowed.updateData(bar(4500, 0, 1.4, 1.5, 1.4, 1.5, 150)));
+}
@@ -0,0 +1,62 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "EpochWorkers.h"
+
+TEST(EpochWorkersTest, everyShardRunsOncePerEpoch) {
+    EpochWorkers workers(4, false);
+    ASSERT_EQ(workers.size(), 4);
+
+    std::vector<std::atomic<int>> calls(4);
+    for (auto& c : calls) c = 0;
+
+    for (int epoch = 0; epoch < 50; epoch++) {
+        workers.run([&calls](unsigned worker) { calls[worker]++; });
+    }
+
+    for (auto& c : calls) EXPECT_EQ(c.load(), 50);
+}
+
+TEST(EpochWorkersTest, slotsKeepTheirWorker) {
+    EpochWorkers workers(3, false);
+    EXPECT_EQ(workers.shardOf(0), 0);
+    EXPECT_EQ(workers.shardOf(4), 1);
+    EXPECT_EQ(workers.shardOf(7), workers.shardOf(7 + 3 * 10));
+
+    // The same shard is always served by the same thread
+    std::vector<std::thread::id> first(3);
+    workers.run([&first](unsigned worker) { first[worker] = std::this_thread::get_id(); });
+
+    for (int epoch = 0; epoch < 20; epoch++) {
+        workers.run([&first](unsigned worker) { EXPECT_EQ(first[worker], std::this_thread::get_id()); });
+    }
+}
+
+TEST(EpochWorkersTest, runWaitsForSlowestShard) {
+    EpochWorkers workers(2, false);
+    std::atomic<int> finished{ 0 };
+
+    workers.run([&finished](unsigned worker) {
+        if (worker == 1) std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        finished++;
+    });
+
+    EXPECT_EQ(finished.load(), 2);
+}
+
+TEST(EpochWorkersTest, shardExceptionIsRethrown) {
+    EpochWorkers workers(2, false);
+    EXPECT_THROW(workers.run([](unsigned worker) { if (worker == 1) throw std::runtime_error("bad candle"); }),
+        std::runtime_error);
+
+    // The pool is still usable afterwards
+    std::atomic<int> calls{ 0 };
+    workers.run([&calls](unsigned) { calls++; });
+    EXPECT_EQ(calls.load(), 2);
+}
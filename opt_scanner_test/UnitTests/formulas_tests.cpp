@@ -0,0 +1,74 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "Formulas.h"
+
+namespace {
+    void naiveStats(const std::vector<double>& v, size_t from, double& mean, double& sd) {
+        mean = 0;
+        for (size_t i = from; i < v.size(); i++) mean += v[i];
+        mean /= (v.size() - from);
+
+        double var = 0;
+        for (size_t i = from; i < v.size(); i++) var += (v[i] - mean) * (v[i] - mean);
+        sd = std::sqrt(var / (v.size() - from));
+    }
+}
+
+TEST(StandardDeviationTest, sessionIsStableForLargeValues) {
+    // Large volumes with a small spread lose every digit to cancellation with sum of squares
+    StandardDeviation sd;
+    std::vector<double> v;
+    for (int i = 0; i < 1000; i++) {
+        v.push_back(1e9 + (i % 10));
+        sd.addValue(v.back());
+    }
+
+    double mean, expected;
+    naiveStats(v, 0, mean, expected);
+    EXPECT_NEAR(sd.mean(), mean, 1e-6);
+    EXPECT_NEAR(sd.stDev(), expected, 1e-6);
+    EXPECT_EQ(sd.count(), 1000);
+}
+
+TEST(StandardDeviationTest, windowDropsOldValues) {
+    StandardDeviation sd(StatsBaseline::lastN(50));
+    std::vector<double> v;
+    for (int i = 0; i < 537; i++) {
+        // A busy open followed by a quiet session
+        v.push_back(i < 200 ? 5000.0 + (i * 37) % 400 : 100.0 + (i * 13) % 20);
+        sd.addValue(v.back());
+    }
+
+    double mean, expected;
+    naiveStats(v, v.size() - 50, mean, expected);
+    EXPECT_NEAR(sd.mean(), mean, 1e-9);
+    EXPECT_NEAR(sd.stDev(), expected, 1e-9);
+    EXPECT_EQ(sd.count(), 50);
+    EXPECT_NEAR(sd.numStDev(mean + expected), 1.0, 1e-9);
+}
+
+TEST(StandardDeviationTest, ewmaDecaysTowardRecentValues) {
+    StandardDeviation sd(StatsBaseline::ewmaSpan(19));
+    EXPECT_DOUBLE_EQ(sd.baseline().alpha, 0.1);
+
+    for (int i = 0; i < 100; i++) sd.addValue(1000);
+    EXPECT_DOUBLE_EQ(sd.mean(), 1000);
+    EXPECT_DOUBLE_EQ(sd.stDev(), 0);
+
+    for (int i = 0; i < 200; i++) sd.addValue(i % 2 == 0 ? 9 : 11);
+    EXPECT_NEAR(sd.mean(), 10, 0.2);
+    EXPECT_GT(sd.stDev(), 0.5);
+    EXPECT_LT(sd.stDev(), 1.5);
+}
+
+TEST(StandardDeviationTest, emptyStatsReturnZero) {
+    StandardDeviation sd;
+    EXPECT_EQ(sd.stDev(), 0);
+    EXPECT_EQ(sd.numStDev(10), 0);
+
+    sd.addValue(4);
+    EXPECT_EQ(sd.stDev(), 0);
+    EXPECT_EQ(sd.numStDev(10), 0);
+}
@@ -0,0 +1,89 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <thread>
+#include <vector>
+
+#include "Candle.h"
+#include "IngestRing.h"
+
+TEST(IngestRingTest, capacityRoundsToPowerOfTwo) {
+    IngestRing<int> ring{ 40 };
+    EXPECT_EQ(ring.capacity(), 64);
+    EXPECT_EQ(ring.size(), 0);
+    EXPECT_EQ(ring.dropped(), 0);
+}
+
+TEST(IngestRingTest, pushAndPopInOrder) {
+    IngestRing<int> ring{ 8 };
+    for (int i = 0; i < 5; i++) EXPECT_TRUE(ring.tryPush(i));
+
+    int value = -1;
+    for (int i = 0; i < 5; i++) {
+        EXPECT_TRUE(ring.tryPop(value));
+        EXPECT_EQ(value, i);
+    }
+
+    EXPECT_FALSE(ring.tryPop(value));
+}
+
+TEST(IngestRingTest, overflowIsCountedNotBlocked) {
+    IngestRing<int> ring{ 4 };
+    for (int i = 0; i < 4; i++) EXPECT_TRUE(ring.tryPush(i));
+
+    EXPECT_FALSE(ring.tryPush(99));
+    EXPECT_FALSE(ring.tryPush(100));
+    EXPECT_EQ(ring.dropped(), 2);
+
+    // Freeing a slot allows publishing again
+    int value;
+    EXPECT_TRUE(ring.tryPop(value));
+    EXPECT_TRUE(ring.tryPush(4));
+    EXPECT_EQ(ring.consumeAll([](int) {}), 4);
+}
+
+TEST(IngestRingTest, candlesMoveThroughRing) {
+    IngestRing<Candle> ring{ 16 };
+    EXPECT_TRUE(ring.tryPush(Candle(4500, 1691347530, 1.0, 1.5, 0.5, 1.2, 250, 1.1, 10)));
+    EXPECT_TRUE(ring.tryPush(Candle(4501, 1691347530, 2.0, 2.5, 1.5, 2.2, 150, 2.1, 5)));
+
+    std::vector<Candle> received;
+    ring.consumeAll([&](Candle&& c) { received.push_back(c); });
+
+    ASSERT_EQ(received.size(), 2);
+    EXPECT_EQ(received[0].reqId(), 4500);
+    EXPECT_EQ(received[0].volume(), 250);
+    EXPECT_EQ(received[1].reqId(), 4501);
+    EXPECT_DOUBLE_EQ(received[1].close(), 2.2);
+}
+
+TEST(IngestRingTest, multipleProducersSingleConsumer) {
+    const int producers = 4;
+    const int perProducer = 20000;
+    IngestRing<std::pair<int, int>> ring{ 256 };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&ring, p, perProducer] {
+            for (int i = 0; i < perProducer; i++) {
+                while (!ring.tryPush(std::make_pair(p, i))) std::this_thread::yield();
+            }
+        });
+    }
+
+    // Each producer's values must arrive complete and in order
+    std::vector<int> next(producers, 0);
+    int received = 0;
+    std::pair<int, int> value;
+    while (received < producers * perProducer) {
+        if (!ring.tryPop(value)) continue;
+        EXPECT_EQ(value.second, next[value.first]);
+        next[value.first] = value.second + 1;
+        received++;
+    }
+
+    for (auto& t : threads) t.join();
+
+    for (int p = 0; p < producers; p++) EXPECT_EQ(next[p], perProducer);
+}
@@ -0,0 +1,234 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "ContractData.h"
+#include "DatabaseManager.h"
+#include "OutcomeTracker.h"
+#include "PerformanceResults.h"
+#include "../MockClasses/TestCandles.h"
+
+using Alerts::OutcomeGrid;
+using Alerts::OutcomeResult;
+using Alerts::OutcomeTracker;
+
+namespace {
+    // The single 30 minute, +60% / -30% outcome
+    std::shared_ptr<const OutcomeGrid> oneCell() {
+        std::shared_ptr<OutcomeGrid> grid = std::make_shared<OutcomeGrid>();
+        grid->horizons = { 1800 };
+        grid->targets = { 60 };
+        grid->stops = { -30 };
+        return grid;
+    }
+
+    std::shared_ptr<Candle> bar(int i, double low, double high, double close) { return TestCandles::bar(5000, i, low, high, low, close, 10); }
+
+    std::shared_ptr<Alerts::PerformanceResults> alertOn(std::shared_ptr<Candle> c, std::shared_ptr<const OutcomeGrid> grid = oneCell()) {
+        return std::make_shared<Alerts::PerformanceResults>(std::make_shared<CandleTags>(c, TimeFrame::FiveSecs,
+            Alerts::OptionType::Call, Alerts::TimeOfDay::Hour1, Alerts::VolumeStDev::Over1, Alerts::VolumeThreshold::Vol100,
+            Alerts::PriceDelta::Under1, Alerts::DailyHighsAndLows::Inside, Alerts::LocalHighsAndLows::Inside), grid);
+    }
+}
+
+TEST(OutcomeTrackerTest, partialWinAfterTheWindow) {
+    OutcomeTracker t(1000, 2.0, oneCell());
+    EXPECT_FALSE(t.update(1000, 2.1, 1.9));
+    EXPECT_FALSE(t.update(1005, 2.6, 2.0)); // +30%, the high
+    EXPECT_FALSE(t.update(1010, 2.6, 1.8));
+    EXPECT_FALSE(t.update(1005, 9.0, 0.1)); // Already seen, ignored
+    EXPECT_FALSE(t.done());
+
+    t.close();
+    EXPECT_EQ(t.state(), OutcomeTracker::State::Closed);
+    OutcomeResult r = t.result();
+    EXPECT_EQ(r.winLoss, 0.5f);
+    EXPECT_NEAR(r.winLossPct, 30.0, 1e-9);
+    EXPECT_EQ(r.timeToWin, 5);
+}
+
+TEST(OutcomeTrackerTest, settlesOnTheStopBar) {
+    OutcomeTracker t(1000, 1.0, oneCell());
+    EXPECT_FALSE(t.update(995, 5.0, 0.1)); // Before the alert
+    EXPECT_FALSE(t.update(1005, 1.05, 0.9));
+    EXPECT_TRUE(t.update(1010, 1.0, 0.7));
+    EXPECT_EQ(t.state(), OutcomeTracker::State::StoppedOut);
+
+    // Later bars don't change a settled outcome
+    EXPECT_TRUE(t.update(1015, 3.0, 0.7));
+    OutcomeResult r = t.result();
+    EXPECT_EQ(r.winLoss, 0.0f); // Gain of 0.05 is negligible
+    EXPECT_NEAR(r.winLossPct, 5.0, 1e-9);
+    EXPECT_EQ(t.bars(), 2u);
+}
+
+TEST(OutcomeTrackerTest, settlesOnTheTargetBar) {
+    OutcomeTracker t(1000, 1.0, oneCell());
+    EXPECT_TRUE(t.update(1020, 1.6, 0.95));
+    EXPECT_EQ(t.state(), OutcomeTracker::State::HitTarget);
+
+    OutcomeResult r = t.result();
+    EXPECT_EQ(r.winLoss, 1.0f);
+    EXPECT_NEAR(r.winLossPct, 60.0, 1e-9);
+    EXPECT_EQ(r.timeToWin, 20);
+}
+
+TEST(OutcomeTrackerTest, contractFeedsPendingAlerts) {
+    ContractData cd(5000);
+    std::vector<std::shared_ptr<Alerts::PerformanceResults>> recorded;
+    cd.registerOutcome([&recorded](std::shared_ptr<Alerts::PerformanceResults> a) { recorded.push_back(a); });
+
+    std::shared_ptr<Candle> first = bar(0, 1.0, 1.05, 1.0);
+    cd.updateData(first);
+
+    // Seeded with the alert's own bar
+    std::shared_ptr<Alerts::PerformanceResults> win = alertOn(first);
+    std::shared_ptr<Alerts::PerformanceResults> open = alertOn(first);
+    cd.trackOutcome(win);
+    cd.trackOutcome(open);
+    EXPECT_EQ(win->outcome.bars(), 1u);
+    EXPECT_EQ(cd.pendingOutcomes(), 2u);
+
+    cd.updateData(bar(1, 1.0, 1.2, 1.1));
+    EXPECT_TRUE(recorded.empty());
+
+    // Target hit, both settle on this bar
+    cd.updateData(bar(2, 1.1, 1.7, 1.6));
+    ASSERT_EQ(recorded.size(), 2u);
+    EXPECT_EQ(recorded[0]->winLoss, 1.0f);
+    EXPECT_EQ(recorded[0]->timeToWin, 10);
+    EXPECT_EQ(cd.pendingOutcomes(), 0u);
+
+    // Nothing left to close once the window ends
+    EXPECT_FALSE(cd.closeOutcome(win));
+}
+
+TEST(OutcomeTrackerTest, closeSettlesWhatWasSeen) {
+    ContractData cd(5000);
+    std::shared_ptr<Candle> first = bar(0, 2.0, 2.0, 2.0);
+    cd.updateData(first);
+
+    std::shared_ptr<Alerts::PerformanceResults> a = alertOn(first);
+    cd.trackOutcome(a);
+    for (int i = 1; i < 100; i++) cd.updateData(bar(i, 1.9, 2.05, 2.0));
+
+    EXPECT_EQ(a->winLoss, -1.0f);
+    EXPECT_TRUE(cd.closeOutcome(a));
+    EXPECT_EQ(a->winLoss, 0.0f);
+    EXPECT_NEAR(a->winLossPct, 2.5, 1e-9);
+    EXPECT_EQ(cd.pendingOutcomes(), 0u);
+}
+
+TEST(OutcomeTrackerTest, primaryIsRecordedBeforeTheGrid) {
+    ContractData cd(5000);
+    std::vector<std::shared_ptr<Alerts::PerformanceResults>> primaries;
+    std::vector<std::shared_ptr<Alerts::PerformanceResults>> grids;
+    cd.registerOutcome([&primaries](std::shared_ptr<Alerts::PerformanceResults> a) { primaries.push_back(a); });
+    cd.registerOutcomeGrid([&grids](std::shared_ptr<Alerts::PerformanceResults> a) { grids.push_back(a); });
+
+    std::shared_ptr<Candle> first = bar(0, 1.0, 1.0, 1.0);
+    cd.updateData(first);
+    std::shared_ptr<Alerts::PerformanceResults> a = alertOn(first, OutcomeGrid::standard());
+    cd.trackOutcome(a);
+
+    // Up 70% settles the +60% primary, the grid still waits on +100% or -50%
+    cd.updateData(bar(1, 1.0, 1.7, 1.5));
+    ASSERT_EQ(primaries.size(), 1u);
+    EXPECT_EQ(a->winLoss, 1.0f);
+    EXPECT_EQ(a->timeToWin, 5);
+    EXPECT_TRUE(grids.empty());
+    EXPECT_EQ(cd.pendingOutcomes(), 1u);
+
+    // The window ends with only the grid left to report
+    cd.updateData(bar(2, 1.2, 1.5, 1.3));
+    EXPECT_TRUE(cd.closeOutcome(a));
+    EXPECT_EQ(primaries.size(), 1u);
+    ASSERT_EQ(grids.size(), 1u);
+    EXPECT_EQ(a->outcomes.primary().winLoss, a->winLoss);
+    EXPECT_EQ(a->outcomes.at(0, 3, 0).winLoss, 0.5f); // 100% in a minute wasn't reached
+}
+
+TEST(OutcomeTrackerTest, primaryOffTheGridIsRejected) {
+    std::shared_ptr<OutcomeGrid> grid = std::make_shared<OutcomeGrid>();
+    grid->horizons = { 60, 300 }; // The primary horizon is still 30 minutes
+
+    EXPECT_THROW(grid->primaryCell(), std::invalid_argument);
+    EXPECT_THROW(OutcomeTracker(1000, 1.0, grid), std::invalid_argument);
+}
+
+TEST(OutcomeTrackerTest, outcomesWaitForTheirCandleRow) {
+    // Settled while the db thread hasn't posted the first alert's candle yet
+    std::shared_ptr<Alerts::PerformanceResults> held = alertOn(bar(0, 1.0, 1.0, 1.0));
+    std::shared_ptr<Alerts::PerformanceResults> posted = alertOn(bar(1, 1.0, 1.0, 1.0));
+    posted->ct->setSqlId(7);
+
+    std::deque<std::shared_ptr<Alerts::PerformanceResults>> queue{ held, posted };
+    std::vector<std::shared_ptr<Alerts::PerformanceResults>> batch;
+    OptionDB::takePosted(queue, batch);
+    ASSERT_EQ(batch.size(), 1u);
+    EXPECT_EQ(batch[0], posted);
+    ASSERT_EQ(queue.size(), 1u);
+
+    // Goes in with the next batch once OptionTable::post has given its candle an id
+    held->ct->setSqlId(8);
+    batch.clear();
+    OptionDB::takePosted(queue, batch);
+    ASSERT_EQ(batch.size(), 1u);
+    EXPECT_EQ(batch[0]->ct->getSqlId(), 8);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST(OutcomeTrackerTest, oneBarPassFillsEveryCell) {
+    std::shared_ptr<OutcomeGrid> grid = std::make_shared<OutcomeGrid>();
+    grid->horizons = { 60, 300 };
+    grid->targets = { 20, 60 };
+    grid->stops = { -10, -30 };
+    grid->primaryHorizon = 300;
+    grid->primaryTarget = 60;
+    grid->primaryStop = -30;
+
+    // Up 25% in the first minute, down 15% by the fourth, back up 50% before five
+    OutcomeTracker t(1000, 1.0, grid);
+    t.update(1000, 1.0, 1.0);
+    t.update(1030, 1.25, 1.0);
+    t.update(1240, 1.1, 0.85);
+    t.update(1290, 1.5, 1.1);
+    EXPECT_TRUE(t.update(1300, 3.0, 3.0)); // Past the longest horizon, not counted
+    EXPECT_EQ(t.state(), OutcomeTracker::State::Closed);
+
+    Alerts::OutcomeMatrix m = t.results();
+
+    // One minute, the 20% target was hit at 30 seconds
+    EXPECT_EQ(m.at(0, 0, 0).winLoss, 1.0f);
+    EXPECT_EQ(m.at(0, 0, 0).timeToWin, 30);
+    EXPECT_EQ(m.at(0, 1, 1).winLoss, 0.5f);
+    EXPECT_NEAR(m.at(0, 1, 1).winLossPct, 25.0, 1e-9);
+
+    // Five minutes, a 60% target with the -10% stop ends on the drop
+    EXPECT_EQ(m.at(1, 1, 0).winLoss, 0.5f);
+    EXPECT_NEAR(m.at(1, 1, 0).winLossPct, 25.0, 1e-9);
+    EXPECT_EQ(m.at(1, 1, 1).winLoss, 0.5f);
+    EXPECT_NEAR(m.at(1, 1, 1).winLossPct, 50.0, 1e-9);
+    EXPECT_EQ(m.at(1, 1, 1).timeToWin, 290);
+    EXPECT_EQ(m.at(1, 0, 1).timeToWin, 30); // The 20% target still ends at 30 seconds
+
+    // The primary cell is the alert's result
+    EXPECT_EQ(t.result().winLossPct, m.primary().winLossPct);
+    EXPECT_EQ(m.primary().timeToWin, 290);
+}
+
+TEST(OutcomeTrackerTest, settlesOnceTheHighestTargetIsHit) {
+    OutcomeTracker t(1000, 1.0);
+    EXPECT_FALSE(t.update(1005, 1.5, 1.0));
+    EXPECT_TRUE(t.update(1010, 2.1, 1.4));
+    EXPECT_EQ(t.state(), OutcomeTracker::State::HitTarget);
+
+    // Every horizon shares the result since the window ended 10 seconds in
+    Alerts::OutcomeMatrix m = t.results();
+    const OutcomeGrid& grid = m.grid();
+    for (size_t h = 0; h < grid.horizons.size(); h++) {
+        EXPECT_EQ(m.at(h, grid.targets.size() - 1, 0).winLoss, 1.0f);
+        EXPECT_EQ(m.at(h, 0, 0).timeToWin, 5);
+    }
+    EXPECT_EQ(m.primary().winLoss, 1.0f);
+}
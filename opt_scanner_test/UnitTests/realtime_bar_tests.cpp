@@ -0,0 +1,59 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <cstring>
+
+#include "Candle.h"
+#include "IngestRing.h"
+#include "RealtimeBar.h"
+
+TEST(RealtimeBarTest, pricesRoundTripInCents) {
+    RealtimeBar bar = RealtimeBar::make(1234, 1691347530, 4500.25, 4502.5, 4499.75, 4501.1, 1200, 3);
+
+    EXPECT_EQ(bar.open, 450025);
+    EXPECT_EQ(bar.close, 450110);
+    EXPECT_DOUBLE_EQ(bar.closePrice(), 4501.1);
+
+    // Option prices trade in nickels and dimes
+    RealtimeBar opt = RealtimeBar::make(5000, 1691347530, 1.15, 1.2, 1.05, 1.1, 40);
+    EXPECT_EQ(opt.low, 105);
+    EXPECT_EQ(opt.slot, -1);
+    EXPECT_EQ(opt.highPrice(), 1.2);
+}
+
+TEST(RealtimeBarTest, candleConversionKeepsTheRealtimeFields) {
+    RealtimeBar bar = RealtimeBar::make(1234, 1691347530, 4500.25, 4502.5, 4499.75, 4501.1, 1200, 3);
+    Candle c(bar);
+
+    EXPECT_EQ(c.reqId(), 1234);
+    EXPECT_EQ(c.time(), 1691347530);
+    EXPECT_EQ(c.open(), 4500.25);
+    EXPECT_EQ(c.high(), 4502.5);
+    EXPECT_EQ(c.low(), 4499.75);
+    EXPECT_EQ(c.close(), 4501.1);
+    EXPECT_EQ(c.volume(), 1200);
+    EXPECT_EQ(c.slot(), 3);
+
+    RealtimeBar back = c.toRealtimeBar();
+    EXPECT_EQ(std::memcmp(&back, &bar, sizeof(RealtimeBar)), 0);
+}
+
+TEST(RealtimeBarTest, volumeIsClampedTo32Bits) {
+    RealtimeBar bar = RealtimeBar::make(1, 0, 1, 1, 1, 1, 5000000000L);
+    EXPECT_EQ(bar.volume, std::numeric_limits<int32_t>::max());
+}
+
+TEST(RealtimeBarTest, passesThroughTheIngestRing) {
+    IngestRing<RealtimeBar> ring{ 4 };
+    for (int i = 0; i < 4; i++) ring.tryPush(RealtimeBar::make(i, 1691347530 + i * 5, 1, 2, 0.5, 1.5, 10 * i, i));
+
+    std::vector<Candle> candles;
+    ring.consumeAll([&candles](RealtimeBar&& bar) { candles.emplace_back(bar); });
+
+    ASSERT_EQ(candles.size(), 4u);
+    EXPECT_EQ(candles[3].reqId(), 3);
+    EXPECT_EQ(candles[3].volume(), 30);
+    EXPECT_EQ(candles[3].low(), 0.5);
+    EXPECT_EQ(candles[2].slot(), 2);
+}
@@ -0,0 +1,120 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <thread>
+
+#include "RequestRegistry.h"
+
+TEST(RequestRegistryTest, snapshotCompletesOnEnd) {
+    RequestRegistry registry;
+    auto f = registry.expectSnapshot(111);
+
+    EXPECT_TRUE(registry.snapshotTick(111, TickType::BID, 4499.5));
+    EXPECT_TRUE(registry.snapshotTick(111, TickType::LAST, 4500.25));
+    EXPECT_EQ(f.wait_for(std::chrono::milliseconds(0)), std::future_status::timeout);
+
+    EXPECT_TRUE(registry.snapshotEnd(111));
+    MarketSnapshot snap = f.get();
+    EXPECT_DOUBLE_EQ(snap.last, 4500.25);
+    EXPECT_DOUBLE_EQ(snap.bid, 4499.5);
+    EXPECT_DOUBLE_EQ(snap.ask, 0);
+    EXPECT_FALSE(registry.isPending(111));
+}
+
+TEST(RequestRegistryTest, unregisteredCallbacksAreIgnored) {
+    RequestRegistry registry;
+    EXPECT_FALSE(registry.snapshotTick(5, TickType::LAST, 1.0));
+    EXPECT_FALSE(registry.snapshotEnd(5));
+    EXPECT_FALSE(registry.historicalEnd(5));
+    EXPECT_FALSE(registry.fail(5, 200, "No security definition"));
+}
+
+TEST(RequestRegistryTest, concurrentRequestsDoNotClobber) {
+    RequestRegistry registry;
+    auto hist1 = registry.expectHistoricalData(10);
+    auto hist2 = registry.expectHistoricalData(11);
+    auto snap = registry.expectSnapshot(12);
+    EXPECT_EQ(registry.pendingCount(), 3);
+
+    // Responses interleave on the reader thread
+    std::thread reader([&registry] {
+        for (int i = 0; i < 5; i++) {
+            std::unique_ptr<Candle> c10 = std::make_unique<Candle>(10, 1691347530 + i * 60, 1.0, 2.0, 0.5, 1.5, 100L);
+            registry.historicalBar(10, c10);
+            if (i < 3) {
+                std::unique_ptr<Candle> c11 = std::make_unique<Candle>(11, 1691347530 + i * 60, 1.0, 2.0, 0.5, 1.5, 100L);
+                registry.historicalBar(11, c11);
+            }
+            registry.snapshotTick(12, TickType::LAST, 4500 + i);
+        }
+        registry.snapshotEnd(12);
+        registry.historicalEnd(11);
+        registry.historicalEnd(10);
+    });
+
+    auto bars1 = hist1.get();
+    auto bars2 = hist2.get();
+    MarketSnapshot s = snap.get();
+    reader.join();
+
+    EXPECT_EQ(bars1.size(), 5);
+    EXPECT_EQ(bars2.size(), 3);
+    EXPECT_EQ(bars2[0]->reqId(), 11);
+    EXPECT_DOUBLE_EQ(s.last, 4504);
+    EXPECT_EQ(registry.pendingCount(), 0);
+}
+
+TEST(RequestRegistryTest, errorFailsFuture) {
+    RequestRegistry registry;
+    auto f = registry.expectContractDetails(42);
+
+    EXPECT_TRUE(registry.fail(42, 200, "No security definition has been found"));
+
+    try {
+        f.get();
+        FAIL() << "Expected RequestError";
+    }
+    catch (const RequestError& e) {
+        EXPECT_EQ(e.reqId(), 42);
+        EXPECT_EQ(e.errorCode(), 200);
+    }
+}
+
+TEST(RequestRegistryTest, reusedIdSupersedesEarlierRequest) {
+    RequestRegistry registry;
+    auto first = registry.expectSnapshot(111);
+    auto second = registry.expectSnapshot(111);
+
+    EXPECT_THROW(first.get(), RequestError);
+
+    registry.snapshotTick(111, TickType::CLOSE, 4480);
+    registry.snapshotEnd(111);
+    EXPECT_DOUBLE_EQ(second.get().close, 4480);
+}
+
+TEST(RequestRegistryTest, informationalErrorsAreNotFailures) {
+    EXPECT_FALSE(isRequestFailure(2104));
+    EXPECT_FALSE(isRequestFailure(2176));
+    EXPECT_FALSE(isRequestFailure(10167));
+    EXPECT_TRUE(isRequestFailure(162));
+    EXPECT_TRUE(isRequestFailure(200));
+}
+
+TEST(RequestRegistryTest, unknownHistoricalBarIsLeftWithTheCaller) {
+    RequestRegistry registry;
+    std::unique_ptr<Candle> c = std::make_unique<Candle>(20, 1691347530, 1.0, 2.0, 0.5, 1.5, 100L);
+    EXPECT_FALSE(registry.historicalBar(20, c));
+    ASSERT_NE(c, nullptr);
+
+    auto hist = registry.expectHistoricalData(20);
+    EXPECT_TRUE(registry.historicalBar(20, c));
+    EXPECT_EQ(c, nullptr);
+    registry.historicalEnd(20);
+    EXPECT_EQ(hist.get().size(), 1u);
+
+    // Completed, so later bars fall back to the caller again
+    c = std::make_unique<Candle>(20, 1691347590, 1.0, 2.0, 0.5, 1.5, 100L);
+    EXPECT_FALSE(registry.historicalBar(20, c));
+    EXPECT_NE(c, nullptr);
+}
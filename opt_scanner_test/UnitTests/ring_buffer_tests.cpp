@@ -0,0 +1,76 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "RingBuffer.h"
+
+TEST(RingBufferTest, pushWrapsAndSpillsOldest) {
+    RingBuffer<int> ring(4);
+    std::vector<int> spilled;
+    ring.setSpill([&spilled](const int& v) { spilled.push_back(v); });
+
+    for (int i = 0; i < 10; i++) ring.push(i);
+
+    EXPECT_EQ(ring.size(), 4);
+    EXPECT_EQ(ring.capacity(), 4);
+    EXPECT_EQ(ring.totalPushed(), 10);
+    EXPECT_EQ(ring[0], 6);
+    EXPECT_EQ(ring.back(), 9);
+    EXPECT_EQ(spilled, std::vector<int>({ 0, 1, 2, 3, 4, 5 }));
+}
+
+TEST(RingBufferTest, viewSpansTheWrap) {
+    RingBuffer<int> ring(5);
+    for (int i = 0; i < 7; i++) ring.push(i);
+
+    RingView<int> view = ring.view();
+    EXPECT_EQ(view.size(), 5);
+    EXPECT_EQ(view.firstRun().second + view.secondRun().second, 5);
+    EXPECT_EQ(view.toVector(), std::vector<int>({ 2, 3, 4, 5, 6 }));
+
+    // The view reads the ring in place
+    EXPECT_EQ(&view.back(), &ring.back());
+}
+
+TEST(RingBufferTest, lastReturnsNewest) {
+    RingBuffer<int> ring(6);
+    for (int i = 0; i < 9; i++) ring.push(i);
+
+    EXPECT_EQ(ring.last(2).toVector(), std::vector<int>({ 7, 8 }));
+    EXPECT_EQ(ring.last(5).toVector(), std::vector<int>({ 4, 5, 6, 7, 8 }));
+    EXPECT_EQ(ring.last(100).size(), 6);
+
+    int sum = 0;
+    for (int v : ring.last(3)) sum += v;
+    EXPECT_EQ(sum, 6 + 7 + 8);
+}
+
+TEST(RingBufferTest, shrinkingSpillsDroppedValues) {
+    RingBuffer<int> ring(8);
+    std::vector<int> spilled;
+    ring.setSpill([&spilled](const int& v) { spilled.push_back(v); });
+    for (int i = 0; i < 10; i++) ring.push(i);
+    spilled.clear();
+
+    ring.setCapacity(3);
+    EXPECT_EQ(spilled, std::vector<int>({ 2, 3, 4, 5, 6 }));
+    EXPECT_EQ(ring.view().toVector(), std::vector<int>({ 7, 8, 9 }));
+
+    ring.setCapacity(5);
+    ring.push(10);
+    EXPECT_EQ(ring.view().toVector(), std::vector<int>({ 7, 8, 9, 10 }));
+    EXPECT_EQ(ring.totalPushed(), 11);
+}
+
+TEST(RingBufferTest, vectorConvertsToView) {
+    std::vector<int> v{ 1, 2, 3 };
+    RingView<int> view = v;
+
+    EXPECT_EQ(view.size(), 3);
+    EXPECT_EQ(view.front(), 1);
+    EXPECT_EQ(view.last(1).front(), 3);
+    EXPECT_TRUE(RingView<int>().empty());
+
+    RingBuffer<int> empty(2);
+    EXPECT_THROW(empty.back(), std::out_of_range);
+}
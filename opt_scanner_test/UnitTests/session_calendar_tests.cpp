@@ -0,0 +1,105 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "SessionCalendar.h"
+
+TEST(SessionCalendarTest, summerOpenIsCentralDaylightTime) {
+    SessionCalendar cal;
+    long open = 1691415000; // 2023-08-07 8:30 CDT
+
+    EXPECT_EQ(cal.openTime(open + 100), open);
+    EXPECT_EQ(cal.closeTime(open), open + 6 * 3600 + 1800);
+    EXPECT_EQ(cal.bucket(open - 5), 0);
+    EXPECT_EQ(cal.bucket(open), 1);
+    EXPECT_EQ(cal.bucket(open + 3599), 1);
+    EXPECT_EQ(cal.bucket(open + 3600), 2);
+    EXPECT_EQ(cal.bucket(open + 6 * 3600 + 1799), 7);
+    EXPECT_EQ(cal.bucket(open + 6 * 3600 + 1800), 8);
+
+    EXPECT_EQ(cal.timeOfDay(open + 2 * 3600 + 5), Alerts::TimeOfDay::Hour3);
+    EXPECT_EQ(cal.timeOfDay(open - 600), Alerts::TimeOfDay::Hour1);
+    EXPECT_EQ(cal.timeOfDay(open + 7 * 3600), Alerts::TimeOfDay::Hour7);
+    EXPECT_FALSE(cal.inSession(open + 7 * 3600));
+}
+
+TEST(SessionCalendarTest, daylightSavingMovesTheOpen) {
+    SessionCalendar cal;
+
+    // Friday before the March change opens at 14:30 UTC, the Monday after at 13:30 UTC
+    EXPECT_EQ(cal.openTime(1678458600 + 60), 1678458600);
+    EXPECT_EQ(cal.openTime(1678714200 + 60), 1678714200);
+    EXPECT_EQ(cal.openTime(1702305000 + 60), 1702305000);
+
+    EXPECT_TRUE(SessionCalendar::isUsDst(2023, 3, 12));
+    EXPECT_FALSE(SessionCalendar::isUsDst(2023, 3, 11));
+    EXPECT_TRUE(SessionCalendar::isUsDst(2023, 11, 4));
+    EXPECT_FALSE(SessionCalendar::isUsDst(2023, 11, 5));
+}
+
+TEST(SessionCalendarTest, halfDaysCloseEarly) {
+    SessionCalendar cal;
+    long blackFriday = 1700848740; // 2023-11-24 11:59 CST
+
+    EXPECT_TRUE(cal.isHalfDay(blackFriday));
+    EXPECT_TRUE(cal.inSession(blackFriday));
+    EXPECT_FALSE(cal.inSession(blackFriday + 60));
+    EXPECT_TRUE(SessionCalendar::isUsHalfDay(2023, 7, 3));
+    EXPECT_FALSE(SessionCalendar::isUsHalfDay(2023, 11, 23));
+
+    EXPECT_FALSE(cal.isHalfDay(1691415000));
+    cal.addHalfDay(2023, 8, 7);
+    EXPECT_TRUE(cal.isHalfDay(1691415000));
+}
+
+TEST(SessionCalendarTest, saturdayHolidaysCloseTheFridayBefore) {
+    SessionCalendar cal;
+    long july3 = 1783090800; // 2026-07-03 10:00 CDT, Independence Day is a Saturday
+    long christmasEve = 1640361600; // 2021-12-24 10:00 CST, Christmas is a Saturday
+
+    for (long t : { july3, christmasEve }) {
+        EXPECT_TRUE(cal.isClosed(t));
+        EXPECT_FALSE(cal.isHalfDay(t));
+        EXPECT_FALSE(cal.inSession(t));
+        EXPECT_EQ(cal.bucket(t), cal.numBuckets() + 1);
+    }
+
+    EXPECT_FALSE(SessionCalendar::isUsHalfDay(2026, 7, 3));
+    EXPECT_TRUE(SessionCalendar::isUsObservedHoliday(2021, 12, 24));
+    EXPECT_TRUE(SessionCalendar::isUsHalfDay(2024, 12, 24));
+    EXPECT_FALSE(SessionCalendar::isUsObservedHoliday(2024, 12, 24));
+
+    // Other holidays come from the exchange's list
+    long monday = 1691420400; // 2023-08-07 10:00 CDT
+    EXPECT_FALSE(cal.isClosed(monday));
+    cal.addClosedDay(2023, 8, 7);
+    EXPECT_TRUE(cal.isClosed(monday));
+    EXPECT_FALSE(cal.inSession(monday));
+}
+
+TEST(SessionCalendarTest, bucketWidthIsConfigurable) {
+    SessionCalendar cal(30);
+    long open = 1691415000;
+
+    EXPECT_EQ(cal.numBuckets(), 13);
+    EXPECT_EQ(cal.bucket(open + 1799), 1);
+    EXPECT_EQ(cal.bucket(open + 1800), 2);
+    EXPECT_EQ(cal.bucket(open + 6 * 3600 + 1799), 13);
+
+    // The alert tag stays hourly
+    EXPECT_EQ(cal.timeOfDay(open + 1800), Alerts::TimeOfDay::Hour1);
+}
+
+TEST(SessionCalendarTest, civilDaysRoundTrip) {
+    int y, m, d;
+    for (long days : { -1L, 0L, 59L, 11016L, 19576L, 24837L }) {
+        SessionCalendar::civilFromDays(days, y, m, d);
+        EXPECT_EQ(SessionCalendar::daysFromCivil(y, m, d), days);
+    }
+
+    SessionCalendar::civilFromDays(19576, y, m, d);
+    EXPECT_EQ(y, 2023);
+    EXPECT_EQ(m, 8);
+    EXPECT_EQ(d, 7);
+    EXPECT_EQ(SessionCalendar::weekday(19576), 1);
+}
@@ -0,0 +1,61 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "SlidingExtrema.h"
+#include "ContractData.h"
+#include "../MockClasses/TestCandles.h"
+
+TEST(SlidingExtremaTest, matchesBruteForceWindow) {
+    const size_t window = 7;
+    SlidingMax highs(window);
+    SlidingMin lows(window);
+    std::vector<double> v;
+
+    for (int i = 0; i < 200; i++) {
+        v.push_back(((i * 7919) % 53) * 0.5 - (i % 5 == 0 ? 3.0 : 0.0));
+        highs.push(v.back());
+        lows.push(v.back());
+
+        size_t from = v.size() > window ? v.size() - window : 0;
+        double hi = v[from];
+        double lo = v[from];
+        for (size_t k = from; k < v.size(); k++) {
+            hi = max(hi, v[k]);
+            lo = min(lo, v[k]);
+        }
+
+        ASSERT_DOUBLE_EQ(highs.value(), hi) << "at " << i;
+        ASSERT_DOUBLE_EQ(lows.value(), lo) << "at " << i;
+    }
+}
+
+TEST(SlidingExtremaTest, extremeExpiresAfterWindow) {
+    SlidingMax highs(3);
+    highs.push(10);
+    highs.push(2);
+    highs.push(3);
+    EXPECT_DOUBLE_EQ(highs.value(), 10);
+
+    highs.push(1);
+    EXPECT_DOUBLE_EQ(highs.value(), 3);
+
+    highs.setWindow(1);
+    EXPECT_DOUBLE_EQ(highs.value(), 1);
+}
+
+TEST(SlidingExtremaTest, contractTracksTrailingWindow) {
+    // Priced well above the old 10000 sentinel
+    ContractData cd(5000);
+    cd.setLocalWindow(12);
+
+    for (int i = 0; i < 60; i++) {
+        double base = i < 30 ? 15000.0 + i : 14000.0 + i;
+        cd.updateData(TestCandles::bar(5000, i, base, base + 2, base - 2, base + 1, 100L));
+    }
+
+    EXPECT_DOUBLE_EQ(cd.dailyHigh(), 15000.0 + 29 + 2);
+    EXPECT_DOUBLE_EQ(cd.dailyLow(), 14000.0 + 30 - 2);
+    EXPECT_DOUBLE_EQ(cd.localHigh(), 14000.0 + 59 + 2);
+    EXPECT_DOUBLE_EQ(cd.localLow(), 14000.0 + 48 - 2);
+}
@@ -0,0 +1,114 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <random>
+
+#include "Alerts/TagCube.h"
+
+using namespace Alerts;
+
+namespace {
+    struct Outcome {
+        TagWord tags;
+        double win;
+        double pct;
+    };
+
+    std::vector<Outcome> randomOutcomes(size_t n, unsigned seed) {
+        std::mt19937 rng(seed);
+        const double wins[] = { 0, 0.5, 1 };
+        std::vector<Outcome> out;
+
+        for (size_t i = 0; i < n; i++) {
+            TagWord w;
+            for (size_t c = 0; c < kNumTagCategories; c++) w.set(static_cast<TagCategory>(c), static_cast<int>(rng() % kTagValues[c]));
+            double win = wins[rng() % 3];
+            double pct = win == 0 ? -static_cast<double>(rng() % 3000) / 100 : static_cast<double>(rng() % 20000) / 100;
+            out.push_back({ w, win, pct });
+        }
+        return out;
+    }
+}
+
+TEST(TagCubeTest, queryMatchesAlertTagStatsForOneCategory) {
+    std::vector<Outcome> data = randomOutcomes(5000, 3);
+    TagCube cube;
+    AlertTagStats stats;
+    for (const Outcome& o : data) {
+        cube.add(o.tags, o.win, o.pct);
+        stats.updateStats(o.tags, o.win, o.pct);
+    }
+    EXPECT_EQ(cube.size(), 5000u);
+
+    for (int v = 0; v < kTagValues[TagFields::index(TagCategory::RelativeToMoney)]; v++) {
+        AlertStats expected = stats.relativeToMoneyStats(static_cast<RelativeToMoney>(v));
+        AlertStats got = cube.query(CubeQuery().where(TagCategory::RelativeToMoney, v));
+        EXPECT_EQ(got.totalAlerts(), expected.totalAlerts());
+        EXPECT_DOUBLE_EQ(got.winRate(), expected.winRate());
+        EXPECT_NEAR(got.averageWin(), expected.averageWin(), 1e-9);
+    }
+
+    // No filter is every alert
+    EXPECT_EQ(cube.query(CubeQuery()).totalAlerts(), 5000);
+}
+
+TEST(TagCubeTest, queryMatchesABruteForceScanForAnySubset) {
+    std::vector<Outcome> data = randomOutcomes(3000, 9);
+    TagCube cube;
+    for (const Outcome& o : data) cube.add(o.tags, o.win, o.pct);
+
+    CubeQuery q = CubeQuery().where(TagCategory::TimeFrame, TimeFrame::OneMin)
+        .where(TagCategory::VolumeStDev, VolumeStDev::Over2)
+        .where(TagCategory::OptionType, OptionType::Put);
+
+    double total = 0, weighted = 0, winners = 0, pctSum = 0;
+    for (const Outcome& o : data) {
+        if (o.tags.get<TimeFrame>(TagCategory::TimeFrame) != TimeFrame::OneMin) continue;
+        if (o.tags.get<VolumeStDev>(TagCategory::VolumeStDev) != VolumeStDev::Over2) continue;
+        if (o.tags.get<OptionType>(TagCategory::OptionType) != OptionType::Put) continue;
+        total++;
+        weighted += o.win;
+        if (o.win > 0) {
+            winners++;
+            pctSum += o.pct;
+        }
+    }
+
+    AlertStats got = cube.query(q);
+    ASSERT_GT(total, 0);
+    EXPECT_EQ(got.totalAlerts(), total);
+    EXPECT_DOUBLE_EQ(got.winRate(), weighted / total);
+    EXPECT_NEAR(got.averageWin(), pctSum / winners, 1e-9);
+}
+
+TEST(TagCubeTest, rollUpCoversEveryAlertOnce) {
+    std::vector<Outcome> data = randomOutcomes(4000, 21);
+    TagCube cube;
+    for (const Outcome& o : data) cube.add(o.tags, o.win, o.pct);
+
+    std::vector<TagCategory> dims = { TagCategory::TimeFrame, TagCategory::RelativeToMoney, TagCategory::VolumeStDev };
+    std::vector<std::pair<TagWord, AlertStats>> cells = cube.rollUp(dims);
+
+    double total = 0;
+    for (const auto& cell : cells) {
+        total += cell.second.totalAlerts();
+
+        CubeQuery q;
+        for (TagCategory c : dims) q.where(c, cell.first.value(c));
+        EXPECT_EQ(cube.query(q).totalAlerts(), cell.second.totalAlerts());
+        EXPECT_EQ(cell.first.value(TagCategory::OptionType), 0);
+    }
+
+    EXPECT_EQ(total, 4000);
+    EXPECT_LE(cells.size(), 4u * 11u * 5u);
+}
+
+TEST(TagCubeTest, emptyQueryIsZeroed) {
+    TagCube cube;
+    cube.add(TagWord().set(TagCategory::TimeFrame, TimeFrame::FiveSecs), 1, 80);
+
+    AlertStats none = cube.query(CubeQuery().where(TagCategory::TimeFrame, TimeFrame::FiveMin));
+    EXPECT_EQ(none.totalAlerts(), 0);
+    EXPECT_EQ(none.winRate(), 0);
+}
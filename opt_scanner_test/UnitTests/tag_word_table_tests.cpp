@@ -0,0 +1,74 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <random>
+#include <unordered_map>
+
+#include "Alerts/AlertTags.h"
+#include "TagWordTable.h"
+
+using namespace Alerts;
+
+namespace {
+    TagWord randomTags(std::mt19937& rng) {
+        TagWord w;
+        for (size_t i = 0; i < kNumTagCategories; i++) {
+            w.set(static_cast<TagCategory>(i), static_cast<int>(rng() % kTagValues[i]));
+        }
+        return w;
+    }
+}
+
+TEST(TagWordTableTest, matchesAnUnorderedMapWhileGrowing) {
+    TagWordTable<int> table(8);
+    std::unordered_map<TagWord, int> expected;
+    std::mt19937 rng(11);
+
+    for (int i = 0; i < 20000; i++) {
+        TagWord w = randomTags(rng);
+        table[w] += i;
+        expected[w] += i;
+    }
+
+    EXPECT_EQ(table.size(), expected.size());
+    EXPECT_LE(table.size() * 4, table.capacity() * 3);
+    for (const auto& kv : expected) {
+        const int* value = table.find(kv.first);
+        ASSERT_NE(value, nullptr);
+        EXPECT_EQ(*value, kv.second);
+    }
+
+    size_t visited = 0;
+    table.forEach([&](TagWord w, int v) { EXPECT_EQ(expected.at(w), v); visited++; });
+    EXPECT_EQ(visited, expected.size());
+}
+
+TEST(TagWordTableTest, emptyWordIsAValidKey) {
+    TagWordTable<int> table;
+    EXPECT_EQ(table.find(TagWord()), nullptr);
+
+    table[TagWord()] = 3;
+    ASSERT_NE(table.find(TagWord()), nullptr);
+    EXPECT_EQ(*table.find(TagWord()), 3);
+    EXPECT_EQ(table.size(), 1u);
+}
+
+TEST(TagWordTableTest, tagStatsMarginalsAddUpPerCategory) {
+    AlertTagStats stats;
+    std::mt19937 rng(5);
+
+    for (int i = 0; i < 500; i++) stats.updateStats(randomTags(rng), (i % 3) * 0.5, 40);
+
+    // Every alert lands in exactly one value of each category
+    for (size_t c = 0; c < kNumTagCategories; c++) {
+        double total = 0;
+        for (int v = 0; v < kTagValues[c]; v++) total += stats.tagStats(static_cast<TagCategory>(c), v).totalAlerts();
+        EXPECT_EQ(total, 500) << c;
+    }
+
+    EXPECT_EQ(stats.tagStats(TagCategory::OptionType, 2).totalAlerts(), 0);
+    EXPECT_EQ(stats.optionTypeStats(OptionType::Put).totalAlerts(),
+        stats.tagStats(TagCategory::OptionType, static_cast<int>(OptionType::Put)).totalAlerts());
+    EXPECT_GT(stats.combinationsSeen(), 400u);
+}
@@ -0,0 +1,102 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <memory>
+#include <unordered_set>
+
+#include "Candle.h"
+#include "Alerts/AlertTags.h"
+#include "../MockClasses/TestCandles.h"
+
+using namespace Alerts;
+
+namespace {
+    AlertTags sampleTags() {
+        return AlertTags(OptionType::Put, TimeFrame::OneMin, RelativeToMoney::DeepOTM, TimeOfDay::Hour7, VolumeStDev::LowVol,
+            VolumeThreshold::Vol1000, PriceDelta::Over2, PriceDelta::Under2, DailyHighsAndLows::NDH, LocalHighsAndLows::Inside,
+            DailyHighsAndLows::Inside, LocalHighsAndLows::NLH);
+    }
+}
+
+TEST(TagWordTest, fieldsFitAndDoNotOverlap) {
+    EXPECT_EQ(TagFields::kUsedBits, 28);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumTagCategories; i++) {
+        EXPECT_EQ(seen & TagFields::mask(i), 0u);
+        EXPECT_GE(1 << TagFields::width(i), kTagValues[i]);
+        seen |= TagFields::mask(i);
+    }
+}
+
+TEST(TagWordTest, setOnlyTouchesItsField) {
+    TagWord w;
+    w.set(TagCategory::RelativeToMoney, RelativeToMoney::DeepOTM);
+    w.set(TagCategory::TimeOfDay, TimeOfDay::Hour4);
+    w.set(TagCategory::RelativeToMoney, RelativeToMoney::ITM2);
+
+    EXPECT_EQ(w.get<RelativeToMoney>(TagCategory::RelativeToMoney), RelativeToMoney::ITM2);
+    EXPECT_EQ(w.get<TimeOfDay>(TagCategory::TimeOfDay), TimeOfDay::Hour4);
+    EXPECT_EQ(w.get<OptionType>(TagCategory::OptionType), OptionType::Call);
+}
+
+TEST(TagWordTest, alertTagsRoundTrip) {
+    AlertTags tags = sampleTags();
+    AlertTags unpacked(tags.word());
+
+    EXPECT_EQ(unpacked.word(), tags.word());
+    EXPECT_EQ(unpacked.rtm, RelativeToMoney::DeepOTM);
+    EXPECT_EQ(unpacked.underlyingDailyHL, DailyHighsAndLows::NDH);
+    EXPECT_EQ(unpacked.optionLocalHL, LocalHighsAndLows::NLH);
+
+    AlertTags other = sampleTags();
+    other.optionPriceDelta = PriceDelta::Under1;
+    EXPECT_NE(other.word(), tags.word());
+    EXPECT_TRUE(other < tags || tags < other);
+
+    std::unordered_set<TagWord> seen{ tags.word(), unpacked.word(), other.word() };
+    EXPECT_EQ(seen.size(), 2u);
+}
+
+TEST(TagWordTest, dbIdsMatchTheTagTable) {
+    TagWord w = sampleTags().word();
+
+    // Same ids the AlertTags table is seeded with
+    EXPECT_EQ(w.dbId(TagCategory::OptionType), 2);
+    EXPECT_EQ(w.dbId(TagCategory::TimeFrame), 5);
+    EXPECT_EQ(w.dbId(TagCategory::RelativeToMoney), 17);
+    EXPECT_EQ(w.dbId(TagCategory::TimeOfDay), 24);
+    EXPECT_EQ(w.dbId(TagCategory::VolumeStDev), 29);
+    EXPECT_EQ(w.dbId(TagCategory::VolumeThreshold), 33);
+    EXPECT_EQ(w.dbId(TagCategory::UnderlyingPriceDelta), 37);
+    EXPECT_EQ(w.dbId(TagCategory::OptionPriceDelta), 39);
+    EXPECT_EQ(w.dbId(TagCategory::UnderlyingDailyHighsAndLows), 42);
+    EXPECT_EQ(w.dbId(TagCategory::OptionDailyHighsAndLows), 46);
+    EXPECT_EQ(w.dbId(TagCategory::UnderlyingLocalHighsAndLows), 49);
+    EXPECT_EQ(w.dbId(TagCategory::OptionLocalHighsAndLows), 51);
+
+    for (const auto& tag : TagDBInterface::tagToInt) {
+        TagWord single;
+        single.setDbId(tag.second);
+        TagCategory c = EnumString::str_to_tag_category(tag.first.second);
+        EXPECT_EQ(single.dbId(c), tag.second) << tag.first.first << " " << tag.first.second;
+    }
+}
+
+TEST(TagWordTest, candleTagsFromDbIds) {
+    auto c = TestCandles::bar(1, 0, 1.0, 1.2, 0.9, 1.1, 500);
+    CandleTags ct(c, { 5, 2, 24, 17, 29, 33, 39, 46, 51, 37, 42, 49 });
+
+    EXPECT_EQ(ct.tagWord(), sampleTags().word());
+    EXPECT_EQ(ct.getTimeFrame(), TimeFrame::OneMin);
+    EXPECT_EQ(ct.getLHL(), LocalHighsAndLows::NLH);
+    EXPECT_EQ(ct.getUnderlyingDHL(), DailyHighsAndLows::NDH);
+
+    CandleTags live(c, TimeFrame::OneMin, OptionType::Put, TimeOfDay::Hour7, VolumeStDev::LowVol, VolumeThreshold::Vol1000,
+        PriceDelta::Under2, DailyHighsAndLows::Inside, LocalHighsAndLows::NLH);
+    EXPECT_EQ(live.getUnderlyingLHL(), LocalHighsAndLows::Inside);
+
+    live.addUnderlyingTags(RelativeToMoney::DeepOTM, PriceDelta::Over2, DailyHighsAndLows::NDH, LocalHighsAndLows::Inside);
+    EXPECT_EQ(live.tagWord(), ct.tagWord());
+}
@@ -0,0 +1,184 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include <vector>
+
+#include "TickBarBuilder.h"
+#include "ContractData.h"
+
+namespace {
+    const long long kOpenMs = 1691418600000LL; // 8:30:00 CT, on a 5 second boundary
+
+    RtVolume print(double price, long size, long long timeMs) {
+        RtVolume t;
+        t.price = price;
+        t.size = size;
+        t.timeMs = timeMs;
+        return t;
+    }
+
+    struct BuiltBars {
+        std::vector<Candle> sub;
+        std::vector<Candle> epoch;
+
+        void attach(TickBarBuilder& builder) {
+            builder.setCallbacks(
+                [this](Candle&& c) { sub.push_back(c); },
+                [this](Candle&& c) { epoch.push_back(c); });
+        }
+    };
+}
+
+TEST(TickBarBuilderTest, buildsOneSecondBarsFromTrades) {
+    TickBarBuilder builder;
+    BuiltBars bars;
+    bars.attach(builder);
+    builder.track(4500);
+
+    builder.trade(4500, print(5.0, 10, kOpenMs + 100));
+    builder.trade(4500, print(5.4, 20, kOpenMs + 400));
+    builder.trade(4500, print(4.9, 0, kOpenMs + 900));
+    EXPECT_TRUE(bars.sub.empty());
+
+    // First trade of the next second closes the bar
+    builder.trade(4500, print(5.1, 1, kOpenMs + 1200));
+    ASSERT_EQ(bars.sub.size(), 1);
+
+    const Candle& c = bars.sub[0];
+    EXPECT_EQ(c.reqId(), 4500);
+    EXPECT_EQ(c.time(), kOpenMs / 1000);
+    EXPECT_DOUBLE_EQ(c.open(), 5.0);
+    EXPECT_DOUBLE_EQ(c.high(), 5.4);
+    EXPECT_DOUBLE_EQ(c.low(), 4.9);
+    EXPECT_DOUBLE_EQ(c.close(), 4.9);
+    EXPECT_EQ(c.volume(), 30);
+}
+
+TEST(TickBarBuilderTest, epochBarSpansSubBars) {
+    TickBarBuilder builder;
+    BuiltBars bars;
+    bars.attach(builder);
+    builder.track(4500);
+
+    for (int s = 0; s < 5; s++) builder.trade(4500, print(5.0 + s * 0.1, 10, kOpenMs + s * 1000));
+
+    builder.flush(kOpenMs + 5000);
+    EXPECT_EQ(bars.sub.size(), 5);
+    ASSERT_EQ(bars.epoch.size(), 1);
+
+    EXPECT_EQ(bars.epoch[0].time(), kOpenMs / 1000);
+    EXPECT_DOUBLE_EQ(bars.epoch[0].open(), 5.0);
+    EXPECT_DOUBLE_EQ(bars.epoch[0].close(), 5.4);
+    EXPECT_EQ(bars.epoch[0].volume(), 50);
+}
+
+TEST(TickBarBuilderTest, quietContractsReportFlatEpochBars) {
+    TickBarBuilder builder;
+    BuiltBars bars;
+    bars.attach(builder);
+    builder.track(4500);
+    builder.track(4505);
+
+    builder.flush(kOpenMs + 5000);
+    EXPECT_TRUE(bars.epoch.empty()); // No price yet
+
+    builder.trade(4500, print(5.0, 0, kOpenMs + 6000));
+    builder.flush(kOpenMs + 10000);
+    builder.flush(kOpenMs + 15000);
+
+    ASSERT_EQ(bars.epoch.size(), 2);
+    EXPECT_EQ(bars.epoch[1].time(), kOpenMs / 1000 + 10);
+    EXPECT_DOUBLE_EQ(bars.epoch[1].high(), 5.0);
+    EXPECT_EQ(bars.epoch[1].volume(), 0);
+}
+
+TEST(TickBarBuilderTest, untrackedTicksAreIgnored) {
+    TickBarBuilder builder;
+    BuiltBars bars;
+    bars.attach(builder);
+
+    EXPECT_FALSE(builder.trade(111, print(4500.25, 1, kOpenMs)));
+    builder.flush(kOpenMs + 10000);
+    EXPECT_TRUE(bars.sub.empty());
+    EXPECT_TRUE(bars.epoch.empty());
+}
+
+TEST(TickBarBuilderTest, volumeOnlyPrintsAndLateTrades) {
+    TickBarBuilder builder;
+    BuiltBars bars;
+    bars.attach(builder);
+    builder.track(4500);
+
+    // Volume without a price yet has nowhere to go
+    builder.trade(4500, print(0, 50, kOpenMs));
+    builder.trade(4500, print(5.0, 10, kOpenMs + 100));
+    builder.trade(4500, print(0, 5, kOpenMs + 200));
+
+    // The server clock closed the epoch before this print arrived, it joins the open bar
+    builder.flush(kOpenMs + 5000);
+    builder.trade(4500, print(5.2, 7, kOpenMs + 4900));
+    builder.flush(kOpenMs + 10000);
+
+    ASSERT_EQ(bars.epoch.size(), 2);
+    EXPECT_EQ(bars.epoch[0].volume(), 15);
+    EXPECT_DOUBLE_EQ(bars.epoch[0].close(), 5.0);
+    EXPECT_EQ(bars.epoch[1].time(), kOpenMs / 1000 + 5);
+    EXPECT_EQ(bars.epoch[1].volume(), 7);
+    EXPECT_DOUBLE_EQ(bars.epoch[1].high(), 5.2);
+}
+
+TEST(TickBarBuilderTest, parsesRtVolume) {
+    RtVolume t;
+    ASSERT_TRUE(parseRtVolume("5.10;3;1691418600123;1234;5.05;true", t));
+    EXPECT_DOUBLE_EQ(t.price, 5.1);
+    EXPECT_EQ(t.size, 3);
+    EXPECT_EQ(t.timeMs, 1691418600123LL);
+
+    ASSERT_TRUE(parseRtVolume(";2;1691418600500;1236;5.05;false", t));
+    EXPECT_DOUBLE_EQ(t.price, 0);
+    EXPECT_EQ(t.size, 2);
+
+    EXPECT_FALSE(parseRtVolume("5.10;3", t));
+    EXPECT_FALSE(parseRtVolume("5.10;x;1691418600123;1234", t));
+    EXPECT_FALSE(parseRtVolume("", t));
+}
+
+TEST(TickBarBuilderTest, subBarWidthDividesEpoch) {
+    TickBarBuilder builder(3);
+    EXPECT_EQ(builder.subBarSeconds(), 1);
+
+    builder.setSubBarSeconds(5);
+    EXPECT_EQ(builder.subBarSeconds(), 5);
+
+    builder.setSubBarSeconds(0);
+    EXPECT_EQ(builder.subBarSeconds(), 1);
+}
+
+// A volume spike in the tick bars raises the 5 second alert once, before the 5 second bar closes
+TEST(TickBarBuilderTest, tickBarsRaiseFiveSecondAlertEarly) {
+    ContractData cd(4500);
+    std::vector<std::shared_ptr<CandleTags>> alerts;
+    cd.registerAlert([&alerts](std::shared_ptr<CandleTags> ct) { alerts.push_back(ct); });
+
+    long start = static_cast<long>(kOpenMs / 1000);
+    cd.updateTickBar(std::make_shared<Candle>(4500, start, 5.0, 5.1, 5.0, 5.1, 60L, 0.0, 3));
+    EXPECT_TRUE(alerts.empty());
+
+    cd.updateTickBar(std::make_shared<Candle>(4500, start + 1, 5.1, 5.6, 5.1, 5.5, 80L, 0.0, 4));
+    ASSERT_EQ(alerts.size(), 1);
+    EXPECT_EQ(alerts[0]->candle.volume(), 140);
+    EXPECT_DOUBLE_EQ(alerts[0]->candle.high(), 5.6);
+    EXPECT_EQ(alerts[0]->getTimeFrame(), TimeFrame::FiveSecs);
+
+    cd.updateTickBar(std::make_shared<Candle>(4500, start + 2, 5.5, 5.7, 5.4, 5.6, 200L, 0.0, 6));
+    EXPECT_EQ(alerts.size(), 1);
+
+    // The closed 5 second bar does not alert a second time
+    cd.updateData(std::make_shared<Candle>(4500, start, 5.0, 5.7, 5.0, 5.6, 340L, 0.0, 13));
+    EXPECT_EQ(alerts.size(), 1);
+
+    // The next 5 second bar is alerted as usual
+    cd.updateData(std::make_shared<Candle>(4500, start + 5, 5.6, 5.8, 5.5, 5.7, 300L, 0.0, 10));
+    EXPECT_EQ(alerts.size(), 2);
+}
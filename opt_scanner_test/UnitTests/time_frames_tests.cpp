@@ -0,0 +1,52 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "TimeFrames.h"
+#include "ContractData.h"
+#include "../MockClasses/TestCandles.h"
+
+TEST(TimeFramesTest, ladderIndexesByEnum) {
+    static_assert(tfIndex(TimeFrame::OneMin) == 2, "TimeFrame maps straight to its ladder position");
+    static_assert(baseBarsIn(tfIndex(TimeFrame::FiveMin)) == 60, "5 minutes is 60 five second bars");
+
+    PerTimeFrame<int> counts;
+    for (const TimeFrameSpec& spec : kTimeFrames) counts[spec.tf] = spec.seconds;
+
+    EXPECT_EQ(counts[TimeFrame::FiveSecs], 5);
+    EXPECT_EQ(counts.at(3), 300);
+    EXPECT_EQ(PerTimeFrame<int>::size(), kNumTimeFrames);
+}
+
+TEST(TimeFramesTest, buildUsesEachSpec) {
+    auto capacities = PerTimeFrame<CandleSeries>::build([](const TimeFrameSpec& spec) { return CandleSeries(spec.capacity); });
+
+    for (const TimeFrameSpec& spec : kTimeFrames) EXPECT_EQ(capacities[spec.tf].capacity(), spec.capacity);
+}
+
+TEST(TimeFramesTest, fiveSecTagsUpdateAfterWarmup) {
+    ContractData cd(4500);
+    std::vector<std::shared_ptr<CandleTags>> alerts;
+    cd.registerAlert([&alerts](std::shared_ptr<CandleTags> tags) { alerts.push_back(tags); });
+
+    // A quiet first 30 minutes then one bar with a wide range and heavy volume
+    for (int i = 0; i < 360; i++) {
+        double base = 3.0 + (i % 3) * 0.01;
+        cd.updateData(TestCandles::bar(4500, i, base, base + 0.05 + (i % 2) * 0.01, base - 0.05, base, 150L + (i % 5)));
+    }
+    cd.updateData(TestCandles::bar(4500, 360, 3.0, 4.0, 2.9, 3.9, 5000L));
+
+    std::shared_ptr<CandleTags> last = alerts.back();
+    EXPECT_EQ(last->getTimeFrame(), TimeFrame::FiveSecs);
+    EXPECT_EQ(cd.priceDelta(TimeFrame::FiveSecs), Alerts::PriceDelta::Over2);
+}
+
+TEST(TimeFramesTest, statsBaselineIsFixedOnceStreaming) {
+    ContractData cd(4500);
+    cd.setStatsBaseline(TimeFrame::OneMin, StatsBaseline::lastN(30));
+    EXPECT_EQ(cd.volStDev(TimeFrame::OneMin).baseline().kind, StatsBaseline::Kind::Window);
+
+    cd.updateData(TestCandles::bar(4500, 0, 3.0, 3.1, 2.9, 3.0, 150L));
+    EXPECT_THROW(cd.setStatsBaseline(TimeFrame::FiveSecs, StatsBaseline::ewma(0.1)), std::logic_error);
+    EXPECT_EQ(cd.volStDev(TimeFrame::FiveSecs).baseline().kind, StatsBaseline::Kind::Session);
+}
@@ -0,0 +1,80 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "../pch.h"
+
+#include "TimerWheel.h"
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point t0 = Clock::time_point() + std::chrono::hours(1);
+}
+
+TEST(TimerWheelTest, expiresInDeadlineOrder) {
+    TimerWheel<int> wheel(std::chrono::seconds(1), 64, t0);
+    wheel.schedule(3, t0 + std::chrono::seconds(30));
+    wheel.schedule(1, t0 + std::chrono::seconds(10));
+    wheel.schedule(2, t0 + std::chrono::milliseconds(10500)); // Rounded up to 11s
+
+    EXPECT_EQ(wheel.size(), 3u);
+    EXPECT_EQ(wheel.nextDeadline(), t0 + std::chrono::seconds(10));
+
+    std::vector<int> fired;
+    auto collect = [&fired](int&& v) { fired.push_back(v); };
+
+    EXPECT_EQ(wheel.expire(t0 + std::chrono::milliseconds(9999), collect), 0u);
+    EXPECT_EQ(wheel.expire(t0 + std::chrono::seconds(10), collect), 1u);
+    EXPECT_EQ(wheel.nextDeadline(), t0 + std::chrono::seconds(11));
+
+    wheel.expire(t0 + std::chrono::seconds(40), collect);
+    ASSERT_EQ(fired.size(), 3u);
+    EXPECT_EQ(fired[0], 1);
+    EXPECT_EQ(fired[1], 2);
+    EXPECT_EQ(fired[2], 3);
+    EXPECT_TRUE(wheel.empty());
+    EXPECT_EQ(wheel.nextDeadline(), Clock::time_point::max());
+}
+
+TEST(TimerWheelTest, laterTurnsWaitForTheirOwnTick) {
+    // 64 one second slots, a deadline 100s out shares slot 36 with one 36s out
+    TimerWheel<int> wheel(std::chrono::seconds(1), 64, t0);
+    wheel.schedule(100, t0 + std::chrono::seconds(100));
+    wheel.schedule(36, t0 + std::chrono::seconds(36));
+
+    std::vector<int> fired;
+    auto collect = [&fired](int&& v) { fired.push_back(v); };
+
+    wheel.expire(t0 + std::chrono::seconds(50), collect);
+    ASSERT_EQ(fired.size(), 1u);
+    EXPECT_EQ(fired[0], 36);
+
+    // The slot is still occupied, so the next wake is one turn early and finds nothing
+    EXPECT_LE(wheel.nextDeadline(), t0 + std::chrono::seconds(100));
+    EXPECT_EQ(wheel.expire(t0 + std::chrono::seconds(99), collect), 0u);
+    EXPECT_EQ(wheel.expire(t0 + std::chrono::seconds(100), collect), 1u);
+    EXPECT_EQ(fired[1], 100);
+}
+
+TEST(TimerWheelTest, catchesUpAfterAFullTurn) {
+    TimerWheel<int> wheel(std::chrono::seconds(1), 64, t0);
+    for (int i = 0; i < 1000; i++) wheel.schedule(i, t0 + std::chrono::seconds(i % 200));
+
+    size_t fired = 0;
+    wheel.expire(t0 + std::chrono::seconds(150), [&fired](int&& v) { EXPECT_LE(v % 200, 150); fired++; });
+    EXPECT_EQ(fired, 755u);
+    EXPECT_EQ(wheel.size(), 245u);
+
+    wheel.expire(t0 + std::chrono::seconds(500), [&fired](int&&) { fired++; });
+    EXPECT_EQ(fired, 1000u);
+}
+
+TEST(TimerWheelTest, pastDeadlinesFireOnTheNextExpire) {
+    TimerWheel<int> wheel(std::chrono::seconds(1), 64, t0);
+    wheel.expire(t0 + std::chrono::seconds(20), [](int&&) {});
+
+    wheel.schedule(7, t0 + std::chrono::seconds(5));
+    EXPECT_EQ(wheel.nextDeadline(), t0 + std::chrono::seconds(21));
+
+    int fired = 0;
+    wheel.expire(t0 + std::chrono::seconds(21), [&fired](int&& v) { fired = v; });
+    EXPECT_EQ(fired, 7);
+}